@@ -0,0 +1,82 @@
+%if 0
+/**
+ * @file crc32c.asm
+ *
+ * @author awewsomegamer <awewsomegamer@gmail.com>
+ *
+ * @LICENSE
+ * Arctan-MB2BSP - Multiboot2 Bootstrapper for Arctan Kernel
+ * Copyright (C) 2023-2024 awewsomegamer
+ *
+ * This file is part of Arctan-MB2BSP
+ *
+ * Arctan is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; version 2
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * @DESCRIPTION
+ * CRC32C with the SSE4.2 crc32 instruction.
+*/
+%endif
+bits 32
+
+global _x86_crc32c
+_x86_crc32c:        push esi
+                    mov eax, [esp + 8]                  ; CRC
+                    mov esi, [esp + 12]                 ; Data
+                    mov ecx, [esp + 16]                 ; Size
+                    mov edx, ecx
+                    shr ecx, 2
+                    jz .bytes
+.dwords:            crc32 eax, dword [esi]
+                    add esi, 4
+                    dec ecx
+                    jnz .dwords
+.bytes:             and edx, 3
+                    jz .done
+.byte:              crc32 eax, byte [esi]
+                    inc esi
+                    dec edx
+                    jnz .byte
+.done:              pop esi
+                    ret
+
+global _x86_crc32c_3way
+_x86_crc32c_3way:   push ebx
+                    push esi
+                    push edi
+                    push ebp
+                    mov ecx, [esp + 20]                 ; CRCs
+                    mov eax, [ecx]
+                    mov ebx, [ecx + 4]
+                    mov edx, [ecx + 8]
+                    mov esi, [esp + 24]                 ; First stream
+                    mov ebp, [esp + 28]                 ; Length of each stream
+                    lea edi, [esi + ebp]                ; Second, the third is at edi + ebp
+                    mov ecx, ebp
+                    shr ecx, 2
+.loop:              crc32 eax, dword [esi]              ; Three independent chains hide
+                    crc32 ebx, dword [edi]              ; the instruction's latency
+                    crc32 edx, dword [edi + ebp]
+                    add esi, 4
+                    add edi, 4
+                    dec ecx
+                    jnz .loop
+                    mov ecx, [esp + 20]
+                    mov [ecx], eax
+                    mov [ecx + 4], ebx
+                    mov [ecx + 8], edx
+                    pop ebp
+                    pop edi
+                    pop esi
+                    pop ebx
+                    ret
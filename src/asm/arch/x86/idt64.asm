@@ -0,0 +1,197 @@
+%if 0
+/**
+ * @file idt64.asm
+ *
+ * @author awewsomegamer <awewsomegamer@gmail.com>
+ *
+ * @LICENSE
+ * Arctan-MB2BSP - Multiboot2 Bootstrapper for Arctan Kernel
+ * Copyright (C) 2023-2024 awewsomegamer
+ *
+ * This file is part of Arctan-MB2BSP
+ *
+ * Arctan is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; version 2
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * @DESCRIPTION
+ * 64-bit exception stubs, recording exceptions taken before the
+ * kernel installs its own IDT.
+*/
+%endif
+bits 64
+
+CR_COUNT            equ 0                               ; struct ARC_CrashRecord, checked in arctan.h
+CR_VECTOR           equ 4
+CR_ERROR_CODE       equ 8
+CR_RIP              equ 16
+CR_CS               equ 24
+CR_RFLAGS           equ 32
+CR_RSP              equ 40
+CR_CR2              equ 48
+CR_TSC              equ 56
+CR_VECTOR_COUNT     equ 64
+
+BR_CHECKSUM         equ 4                               ; struct ARC_BootRecord, checked in arctan.h
+BR_SIZE             equ 2000
+
+FRAME_VECTOR        equ 48                              ; Offsets from RSP once the
+FRAME_ERROR_CODE    equ 56                              ; registers are saved
+FRAME_RIP           equ 64
+FRAME_CS            equ 72
+FRAME_RFLAGS        equ 80
+FRAME_RSP           equ 88
+
+extern crash_record
+extern boot_record
+extern idt64_log_port
+
+section .text
+
+%macro idt64_stub 1
+align 16
+%if %1 <> 8 && %1 <> 10 && %1 <> 11 && %1 <> 12 && %1 <> 13 && %1 <> 14 && %1 <> 17 && %1 <> 21 && %1 <> 29 && %1 <> 30
+                    push qword 0                        ; No error code, push one to keep the frame uniform
+%endif
+                    push qword %1
+                    jmp _idt64_common
+%endmacro
+
+global _idt64_stubs
+align 16
+_idt64_stubs:
+%assign vector 0
+%rep 32
+idt64_stub vector
+%assign vector vector + 1
+%endrep
+
+_idt64_common:      push rdi
+                    push rsi
+                    push rbx
+                    push rdx
+                    push rcx
+                    push rax
+
+                    mov ebx, dword [rel crash_record]   ; Zero extended into RBX
+                    mov rax, [rsp + FRAME_VECTOR]
+                    mov [rbx + CR_VECTOR], eax
+                    inc dword [rbx + CR_VECTOR_COUNT + rax * 4]
+                    inc dword [rbx + CR_COUNT]
+                    mov rax, [rsp + FRAME_ERROR_CODE]
+                    mov [rbx + CR_ERROR_CODE], rax
+                    mov rax, [rsp + FRAME_RIP]
+                    mov [rbx + CR_RIP], rax
+                    mov rax, [rsp + FRAME_CS]
+                    mov [rbx + CR_CS], rax
+                    mov rax, [rsp + FRAME_RFLAGS]
+                    mov [rbx + CR_RFLAGS], rax
+                    mov rax, [rsp + FRAME_RSP]
+                    mov [rbx + CR_RSP], rax
+                    mov rax, cr2
+                    mov [rbx + CR_CR2], rax
+                    rdtsc
+                    shl rdx, 32
+                    or rax, rdx
+                    mov [rbx + CR_TSC], rax
+
+                    mov esi, dword [rel boot_record]    ; Keep the boot record's
+                    test esi, esi                       ; checksum valid
+                    jz .log
+                    mov byte [rsi + BR_CHECKSUM], 0
+                    xor eax, eax
+                    mov ecx, BR_SIZE
+.sum:               add al, [rsi + rcx - 1]
+                    loop .sum
+                    neg al
+                    mov [rsi + BR_CHECKSUM], al
+
+.log:               movzx edx, word [rel idt64_log_port]
+                    test edx, edx
+                    jz .done
+
+                    lea rsi, [rel msg_vector]
+                    call _idt64_puts
+                    mov eax, [rbx + CR_VECTOR]
+                    shl rax, 56                         ; Only the low two digits
+                    mov ecx, 2
+                    call _idt64_puthex
+                    lea rsi, [rel msg_rip]
+                    call _idt64_puts
+                    mov rax, [rbx + CR_RIP]
+                    mov ecx, 16
+                    call _idt64_puthex
+                    lea rsi, [rel msg_error_code]
+                    call _idt64_puts
+                    mov rax, [rbx + CR_ERROR_CODE]
+                    mov ecx, 16
+                    call _idt64_puthex
+                    lea rsi, [rel msg_cr2]
+                    call _idt64_puts
+                    mov rax, [rbx + CR_CR2]
+                    mov ecx, 16
+                    call _idt64_puthex
+                    lea rsi, [rel msg_tsc]
+                    call _idt64_puts
+                    mov rax, [rbx + CR_TSC]
+                    mov ecx, 16
+                    call _idt64_puthex
+                    mov al, `\n`
+                    out dx, al
+
+.done:              mov eax, [rbx + CR_VECTOR]
+                    cmp eax, 1                          ; #DB and #BP can carry on
+                    je .return
+                    cmp eax, 3
+                    je .return
+
+                    cli
+.halt:              hlt
+                    jmp .halt
+
+.return:            pop rax
+                    pop rcx
+                    pop rdx
+                    pop rbx
+                    pop rsi
+                    pop rdi
+                    add rsp, 16                         ; Vector and error code
+                    iretq
+
+                    ; Write the NUL terminated string at RSI to port DX
+_idt64_puts:        lodsb
+                    test al, al
+                    jz .done
+                    out dx, al
+                    jmp _idt64_puts
+.done:              ret
+
+                    ; Write the top ECX hex digits of RAX to port DX
+_idt64_puthex:      rol rax, 4
+                    push rax
+                    and al, 0xF
+                    add al, '0'
+                    cmp al, '9'
+                    jbe .write
+                    add al, 'A' - '0' - 10
+.write:             out dx, al
+                    pop rax
+                    loop _idt64_puthex
+                    ret
+
+section .rodata
+
+msg_vector:         db `Early exception 0x`, 0
+msg_rip:            db ` RIP 0x`, 0
+msg_error_code:     db ` error code 0x`, 0
+msg_cr2:            db ` CR2 0x`, 0
+msg_tsc:            db ` TSC 0x`, 0
@@ -0,0 +1,105 @@
+%if 0
+/**
+ * @file memory.asm
+ *
+ * @author awewsomegamer <awewsomegamer@gmail.com>
+ *
+ * @LICENSE
+ * Arctan-MB2BSP - Multiboot2 Bootstrapper for Arctan Kernel
+ * Copyright (C) 2023-2024 awewsomegamer
+ *
+ * This file is part of Arctan-MB2BSP
+ *
+ * Arctan is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; version 2
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * @DESCRIPTION
+*/
+%endif
+bits 32
+
+global _x86_memcpy_movsb
+_x86_memcpy_movsb:  push edi
+                    push esi
+                    mov edi, [esp + 12]                 ; Destination
+                    mov esi, [esp + 16]                 ; Source
+                    mov ecx, [esp + 20]                 ; Size
+                    cld
+                    rep movsb                           ; Fast with ERMS
+                    pop esi
+                    pop edi
+                    ret
+
+global _x86_memcpy_movsd
+_x86_memcpy_movsd:  push edi
+                    push esi
+                    mov edi, [esp + 12]                 ; Destination
+                    mov esi, [esp + 16]                 ; Source
+                    mov ecx, [esp + 20]                 ; Size
+                    mov edx, ecx
+                    shr ecx, 2
+                    cld
+                    rep movsd                           ; Copy dwords
+                    mov ecx, edx
+                    and ecx, 3
+                    rep movsb                           ; Copy the remaining bytes
+                    pop esi
+                    pop edi
+                    ret
+
+global _x86_memset_stosb
+_x86_memset_stosb:  push edi
+                    mov edi, [esp + 8]                  ; Destination
+                    mov eax, [esp + 12]                 ; Pattern
+                    mov ecx, [esp + 16]                 ; Size
+                    cld
+                    rep stosb                           ; Fast with ERMS
+                    pop edi
+                    ret
+
+global _x86_memset_stosd
+_x86_memset_stosd:  push edi
+                    mov edi, [esp + 8]                  ; Destination
+                    mov eax, [esp + 12]                 ; Pattern
+                    mov ecx, [esp + 16]                 ; Size
+                    mov edx, ecx
+                    shr ecx, 2
+                    cld
+                    rep stosd                           ; Fill dwords
+                    mov ecx, edx
+                    and ecx, 3
+                    rep stosb                           ; Fill the remaining bytes
+                    pop edi
+                    ret
+
+global _x86_memset_movnti
+_x86_memset_movnti: push edi
+                    mov edi, [esp + 8]                  ; Destination
+                    mov eax, [esp + 12]                 ; Pattern
+                    mov ecx, [esp + 16]                 ; Size
+                    shr ecx, 5                          ; 32 bytes per iteration
+                    jz .done
+.loop:              movnti [edi], eax                   ; Bypass the cache, the memory
+                    movnti [edi + 4], eax               ; will not be read again soon
+                    movnti [edi + 8], eax
+                    movnti [edi + 12], eax
+                    movnti [edi + 16], eax
+                    movnti [edi + 20], eax
+                    movnti [edi + 24], eax
+                    movnti [edi + 28], eax
+                    add edi, 32
+                    dec ecx
+                    jnz .loop
+                    sfence                              ; Order against later stores
+.done:              pop edi
+                    ret
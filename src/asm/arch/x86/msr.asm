@@ -0,0 +1,45 @@
+%if 0
+/**
+ * @file msr.asm
+ *
+ * @author awewsomegamer <awewsomegamer@gmail.com>
+ *
+ * @LICENSE
+ * Arctan-MB2BSP - Multiboot2 Bootstrapper for Arctan Kernel
+ * Copyright (C) 2023-2024 awewsomegamer
+ *
+ * This file is part of Arctan-MB2BSP
+ *
+ * Arctan is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; version 2
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * @DESCRIPTION
+*/
+%endif
+bits 32
+
+global _x86_rdmsr
+_x86_rdmsr:     mov ecx, [esp + 4]
+                rdmsr
+                ret
+
+global _x86_rdtsc
+_x86_rdtsc:     rdtsc
+                ret
+
+global _x86_wrmsr
+_x86_wrmsr:     mov ecx, [esp + 4]
+                mov eax, [esp + 8]
+                mov edx, [esp + 12]
+                wrmsr
+                ret
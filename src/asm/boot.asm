@@ -65,6 +65,7 @@ section .text
 
 extern helper
 extern pml4
+extern vmm_levels
 extern _kernel_station
 global _entry
 extern __BOOTSTRAP_STACK__
@@ -74,9 +75,15 @@ _entry:             mov ebp, __BOOTSTRAP_STACK__                     ; Setup sta
                     push ebx                            ; Push boot information
                     call helper                             ; HELP!
 
-                    mov eax, cr4
-                    or eax, 1 << 5
-                    mov cr4, eax
+global _enter_long_mode
+global bootstrap_cr4
+_enter_long_mode:   mov eax, cr4
+                    mov dword [bootstrap_cr4], eax      ; Restored by _warm_compat
+                    or eax, 1 << 5                      ; PAE
+                    cmp dword [vmm_levels], 5
+                    jne .set_cr4
+                    or eax, 1 << 12                     ; LA57, pml4 is a PML5
+.set_cr4:           mov cr4, eax
 
                     mov eax, dword [pml4]
                     mov cr3, eax
@@ -94,6 +101,8 @@ _entry:             mov ebp, __BOOTSTRAP_STACK__                     ; Setup sta
 
 section .bss
 
+bootstrap_cr4:      resd 1
+
 global _boot_meta
-BOOT_MEMBER_COUNT   equ 16                                  ; Member count
+BOOT_MEMBER_COUNT   equ 64                                  ; Member count
 _boot_meta:         resq BOOT_MEMBER_COUNT
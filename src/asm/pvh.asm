@@ -0,0 +1,53 @@
+%if 0
+/**
+ * @file pvh.asm
+ *
+ * @author awewsomegamer <awewsomegamer@gmail.com>
+ *
+ * @LICENSE
+ * Arctan-MB2BSP - Multiboot2 Bootstrapper for Arctan Kernel
+ * Copyright (C) 2023-2024 awewsomegamer
+ *
+ * This file is part of Arctan-MB2BSP
+ *
+ * Arctan is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; version 2
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * @DESCRIPTION
+ * PVH entry point, lets the bootstrapper be booted directly by a
+ * hypervisor (QEMU -kernel) without a multiboot2 loader.
+*/
+%endif
+bits 32
+
+XEN_ELFNOTE_PHYS32_ENTRY    equ 18
+XEN_HVM_START_MAGIC_VALUE   equ 0x336EC578
+
+section .note.Xen
+
+align 4
+                    dd 4                                ; Name size
+                    dd 4                                ; Descriptor size
+                    dd XEN_ELFNOTE_PHYS32_ENTRY
+                    db "Xen", 0
+                    dd _pvh_entry
+
+section .text
+
+extern _entry
+global _pvh_entry
+                    ; Entered in protected mode with paging disabled and
+                    ; EBX pointing to the hvm_start_info, hand it to helper
+                    ; the same way a multiboot2 loader hands over the MBI
+_pvh_entry:         mov eax, XEN_HVM_START_MAGIC_VALUE
+                    jmp _entry
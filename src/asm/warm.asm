@@ -0,0 +1,95 @@
+%if 0
+/**
+ * @file warm.asm
+ *
+ * @author awewsomegamer <awewsomegamer@gmail.com>
+ *
+ * @LICENSE
+ * Arctan-MB2BSP - Multiboot2 Bootstrapper for Arctan Kernel
+ * Copyright (C) 2023-2024 awewsomegamer
+ *
+ * This file is part of Arctan-MB2BSP
+ *
+ * Arctan is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; version 2
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * @DESCRIPTION
+ * Warm reboot entry point, brings the CPU from the kernel's long
+ * mode back to the bootstrapper's protected mode.
+*/
+%endif
+bits 64
+
+extern gdtr
+extern warm_helper
+extern _enter_long_mode
+extern bootstrap_cr4
+extern __BOOTSTRAP_STACK__
+global _warm_entry
+                    ; Called by the kernel through the identity map with
+                    ; RDI, RSI and RDX holding a struct ARC_WarmArgs
+_warm_entry:        cli
+                    mov rsp, __BOOTSTRAP_STACK__
+                    mov [warm_args], rdi
+                    mov [warm_args + 8], rsi
+                    mov [warm_args + 16], rdx
+
+                    mov rax, cr3                        ; Paging cannot be disabled with
+                    and rax, ~0xFFF                     ; CR4.PCIDE set, switch to PCID 0
+                    mov cr3, rax                        ; before clearing it
+                    mov rax, cr4
+                    and rax, ~(1 << 17)
+                    mov cr4, rax
+
+                    sub rsp, 16                         ; The kernel has its own GDT, load ours
+                    mov ax, word [gdtr]                 ; with a 64-bit base
+                    mov word [rsp], ax
+                    mov eax, dword [gdtr + 2]
+                    mov qword [rsp + 2], rax
+                    lgdt [rsp]
+                    add rsp, 16
+
+                    push qword 0x08                     ; Far return into 32-bit code
+                    push qword _warm_compat
+                    retfq
+
+bits 32
+
+_warm_compat:       mov ax, 0x10
+                    mov ds, ax
+                    mov es, ax
+                    mov fs, ax
+                    mov gs, ax
+                    mov ss, ax
+
+                    mov eax, cr0                        ; Disable paging
+                    and eax, ~(1 << 31)
+                    mov cr0, eax
+
+                    mov ecx, 0xC0000080                 ; Leave long mode
+                    rdmsr
+                    and eax, ~(1 << 8)
+                    wrmsr
+
+                    mov eax, dword [bootstrap_cr4]      ; Drop the kernel's SMEP, SMAP, PGE,
+                    mov cr4, eax                        ; LA57 and so on
+
+                    mov esp, __BOOTSTRAP_STACK__
+                    push warm_args
+                    call warm_helper
+
+                    jmp _enter_long_mode
+
+section .bss
+
+warm_args:          resq 3
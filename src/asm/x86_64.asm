@@ -29,10 +29,62 @@
 bits 64
 
 extern kernel_entry
+extern kernel_stack
+extern kernel_fs_base
+extern resume_context
 extern _boot_meta
 extern _stack_end
+extern idt64r
 global _kernel_station
-_kernel_station:    mov rax, [kernel_entry]
+_kernel_station:    lidt [idt64r]                       ; Catch exceptions until the kernel
+                    mov ax, 0x20                        ; has an IDT (see init_idt64)
+                    ltr ax
+                    mov eax, dword [resume_context]      ; Zero extended into RAX
+                    test rax, rax
+                    jnz _resume_station
+                    mov rax, [kernel_stack]
+                    test rax, rax                       ; Switch to the stack the kernel
+                    jz .enter                           ; asked for, if it asked for one
+                    mov rsp, rax
+.enter:             mov rax, [kernel_fs_base]
+                    test rax, rax                       ; Point FS at the BSP's TLS block
+                    jz .jump                            ; (see create_tls_blocks)
+                    mov rdx, rax
+                    shr rdx, 32
+                    mov ecx, 0xC0000100                 ; IA32_FS_BASE
+                    wrmsr
+.jump:              mov rax, [kernel_entry]
                     lea rdi, [rel _boot_meta]
                     jmp rax
                     jmp $
+
+                    ; Resume the struct ARC_SnapshotContext in RAX, nothing
+                    ; may be written to the restored stack
+_resume_station:    mov rbx, rax
+                    mov rax, [rbx + 32]
+                    and rax, ~(1 << 9)                  ; No interrupts until the kernel has an IDT
+                    push rax                            ; Still on the bootstrapper's stack
+                    popfq
+                    mov rax, [rbx + 16]                 ; RIP, RBX is restored last so keep
+                    mov [resume_rip], rax               ; it out of the way
+                    mov rsp, [rbx + 24]
+                    mov rax, [rbx + 40]
+                    mov rcx, [rbx + 56]
+                    mov rdx, [rbx + 64]
+                    mov rsi, [rbx + 72]
+                    mov rdi, [rbx + 80]
+                    mov rbp, [rbx + 88]
+                    mov r8, [rbx + 96]
+                    mov r9, [rbx + 104]
+                    mov r10, [rbx + 112]
+                    mov r11, [rbx + 120]
+                    mov r12, [rbx + 128]
+                    mov r13, [rbx + 136]
+                    mov r14, [rbx + 144]
+                    mov r15, [rbx + 152]
+                    mov rbx, [rbx + 48]
+                    jmp [resume_rip]
+
+section .bss
+
+resume_rip:         resq 1
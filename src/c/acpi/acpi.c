@@ -0,0 +1,217 @@
+/**
+ * @file acpi.c
+ *
+ * @author awewsomegamer <awewsomegamer@gmail.com>
+ *
+ * @LICENSE
+ * Arctan-MB2BSP - Multiboot2 Bootstrapper for Arctan Kernel
+ * Copyright (C) 2023-2024 awewsomegamer
+ *
+ * This file is part of Arctan-MB2BSP
+ *
+ * Arctan is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; version 2
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * @DESCRIPTION
+ * Minimal ACPI table reader, used to discover what the bootstrapper needs
+ * to know about the system before the kernel is loaded.
+*/
+#include <acpi/acpi.h>
+#include <mm/hhdm.h>
+#include <arch/x86/apic.h>
+#include <global.h>
+
+struct ARC_RSDP {
+	char signature[8];
+	uint8_t checksum;
+	char oem_id[6];
+	uint8_t revision;
+	uint32_t rsdt;
+	uint32_t length;
+	uint64_t xsdt;
+	uint8_t ext_checksum;
+	uint8_t reserved[3];
+}__attribute__((packed));
+
+struct ARC_SDTHeader {
+	char signature[4];
+	uint32_t length;
+	uint8_t revision;
+	uint8_t checksum;
+	char oem_id[6];
+	char oem_table_id[8];
+	uint32_t oem_revision;
+	uint32_t creator_id;
+	uint32_t creator_revision;
+}__attribute__((packed));
+
+struct ARC_MADT {
+	struct ARC_SDTHeader header;
+	uint32_t lapic;
+	uint32_t flags;
+	uint8_t entries[];
+}__attribute__((packed));
+
+struct ARC_HPET {
+	struct ARC_SDTHeader header;
+	uint32_t event_timer_block_id;
+	uint8_t space_id;
+	uint8_t bit_width;
+	uint8_t bit_offset;
+	uint8_t access_size;
+	uint64_t address;
+}__attribute__((packed));
+
+struct ARC_MCFGEntry {
+	uint64_t base;
+	uint16_t segment;
+	uint8_t start_bus;
+	uint8_t end_bus;
+	uint32_t reserved;
+}__attribute__((packed));
+
+#define MADT_LAPIC          0
+#define MADT_IOAPIC         1
+#define MADT_LAPIC_OVERRIDE 5
+#define MADT_X2APIC         9
+
+static int signature_is(struct ARC_SDTHeader *header, const char *signature) {
+	for (int i = 0; i < 4; i++) {
+		if (header->signature[i] != signature[i]) {
+			return 0;
+		}
+	}
+
+	return 1;
+}
+
+static int checksum_ok(void *table, uint32_t length) {
+	uint8_t sum = 0;
+
+	for (uint32_t i = 0; i < length; i++) {
+		sum += *(uint8_t *)(table + i);
+	}
+
+	return sum == 0;
+}
+
+static void parse_madt(struct ARC_MADT *madt) {
+	uint64_t lapic = madt->lapic;
+	uint32_t length = madt->header.length - sizeof(struct ARC_MADT);
+
+	for (uint32_t i = 0; i + 2 <= length && madt->entries[i + 1] != 0; i += madt->entries[i + 1]) {
+		uint8_t *entry = &madt->entries[i];
+
+		switch (entry[0]) {
+		case MADT_LAPIC: {
+			// Count enabled and online capable processors
+			if ((*(uint32_t *)(entry + 4) & 0b11) != 0 && apic_add_cpu(entry[3]) == 0) {
+				_boot_meta.cpu_count++;
+			}
+
+			break;
+		}
+
+		case MADT_X2APIC: {
+			if ((*(uint32_t *)(entry + 8) & 0b11) != 0 && apic_add_cpu(*(uint32_t *)(entry + 4)) == 0) {
+				_boot_meta.cpu_count++;
+			}
+
+			break;
+		}
+
+		case MADT_IOAPIC: {
+			uint32_t ioapic = *(uint32_t *)(entry + 4);
+			ARC_DEBUG(INFO, "IOAPIC %d at 0x%"PRIx32"\n", entry[2], ioapic);
+			hhdm_add_mmio(ioapic, 0x1000, ARC_CACHE_UC);
+
+			break;
+		}
+
+		case MADT_LAPIC_OVERRIDE: {
+			lapic = *(uint64_t *)(entry + 4);
+
+			break;
+		}
+		}
+	}
+
+	ARC_DEBUG(INFO, "%d CPU(s), LAPIC at 0x%"PRIx64"\n", _boot_meta.cpu_count, lapic);
+	hhdm_add_mmio(lapic, 0x1000, ARC_CACHE_UC);
+}
+
+static void parse_hpet(struct ARC_HPET *hpet) {
+	ARC_DEBUG(INFO, "HPET at 0x%"PRIx64"\n", hpet->address);
+	hhdm_add_mmio(hpet->address, 0x1000, ARC_CACHE_UC);
+}
+
+static void parse_mcfg(struct ARC_SDTHeader *mcfg) {
+	// 8 reserved bytes follow the header
+	int count = (mcfg->length - sizeof(struct ARC_SDTHeader) - 8) / sizeof(struct ARC_MCFGEntry);
+	struct ARC_MCFGEntry *entries = (struct ARC_MCFGEntry *)((uintptr_t)mcfg + sizeof(struct ARC_SDTHeader) + 8);
+
+	for (int i = 0; i < count; i++) {
+		uint64_t size = (uint64_t)(entries[i].end_bus - entries[i].start_bus + 1) << 20;
+		uint64_t base = entries[i].base + ((uint64_t)entries[i].start_bus << 20);
+
+		ARC_DEBUG(INFO, "ECAM for segment %d at 0x%"PRIx64" (0x%"PRIx64" B)\n", entries[i].segment, base, size);
+		hhdm_add_mmio(base, size, ARC_CACHE_UC);
+	}
+}
+
+int read_acpi() {
+	struct ARC_RSDP *rsdp = (struct ARC_RSDP *)((uint32_t)_boot_meta.rsdp);
+
+	if (rsdp == NULL) {
+		ARC_DEBUG(WARN, "No RSDP\n");
+		return -1;
+	}
+
+	// Use the XSDT if present, otherwise the RSDT
+	int xsdt = rsdp->revision >= 2 && rsdp->xsdt != 0 && (rsdp->xsdt >> 32) == 0;
+	struct ARC_SDTHeader *root = (struct ARC_SDTHeader *)(xsdt ? (uint32_t)rsdp->xsdt : rsdp->rsdt);
+
+	if (root == NULL || !checksum_ok(root, root->length)) {
+		ARC_DEBUG(ERR, "Invalid %s\n", xsdt ? "XSDT" : "RSDT");
+		return -1;
+	}
+
+	int pointer_size = xsdt ? 8 : 4;
+	int count = (root->length - sizeof(struct ARC_SDTHeader)) / pointer_size;
+
+	for (int i = 0; i < count; i++) {
+		void *pointer = (void *)((uintptr_t)root + sizeof(struct ARC_SDTHeader) + i * pointer_size);
+		uint64_t address = xsdt ? *(uint64_t *)pointer : *(uint32_t *)pointer;
+
+		if ((address >> 32) != 0) {
+			ARC_DEBUG(WARN, "Table %d is above 32-bit address range, ignoring\n", i);
+			continue;
+		}
+
+		struct ARC_SDTHeader *table = (struct ARC_SDTHeader *)((uint32_t)address);
+
+		if (!checksum_ok(table, table->length)) {
+			continue;
+		}
+
+		if (signature_is(table, "APIC")) {
+			parse_madt((struct ARC_MADT *)table);
+		} else if (signature_is(table, "HPET")) {
+			parse_hpet((struct ARC_HPET *)table);
+		} else if (signature_is(table, "MCFG")) {
+			parse_mcfg(table);
+		}
+	}
+
+	return 0;
+}
@@ -0,0 +1,144 @@
+/**
+ * @file apic.c
+ *
+ * @author awewsomegamer <awewsomegamer@gmail.com>
+ *
+ * @LICENSE
+ * Arctan-MB2BSP - Multiboot2 Bootstrapper for Arctan Kernel
+ * Copyright (C) 2023-2024 awewsomegamer
+ *
+ * This file is part of Arctan-MB2BSP
+ *
+ * Arctan is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; version 2
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * @DESCRIPTION
+ * Local APIC mode and the APIC ID to CPU index map.
+*/
+#include <cpuid.h>
+#include <arch/x86/apic.h>
+#include <arch/x86/cpuid.h>
+#include <arch/x86/msr.h>
+#include <mm/freelist.h>
+#include <global.h>
+#include <util.h>
+
+/// IA32_APIC_BASE.EXTD, x2APIC mode.
+#define APIC_BASE_EXTD (1 << 10)
+/// IA32_APIC_BASE.EN, the local APIC is enabled.
+#define APIC_BASE_EN   (1 << 11)
+
+/// APIC IDs of the CPUs, by index.
+static uint32_t apic_ids[ARC_APIC_MAX_CPUS] = { 0 };
+static int apic_id_count = 0;
+
+int init_apic() {
+	register uint32_t eax;
+	register uint32_t ebx;
+	register uint32_t ecx;
+	register uint32_t edx;
+
+	__cpuid(0x01, eax, ebx, ecx, edx);
+
+	if (((edx >> 9) & 1) == 0) {
+		ARC_DEBUG(WARN, "No local APIC\n")
+		_boot_meta.apic_mode = ARC_APIC_NONE;
+		return -1;
+	}
+
+	uint64_t base = _x86_rdmsr(ARC_MSR_APIC_BASE);
+
+	if (ARC_X2APIC && (cpu_features & ARC_CPU_FEATURE_X2APIC) && !(base & APIC_BASE_EXTD)) {
+		// xAPIC mode has to be entered before x2APIC mode
+		base |= APIC_BASE_EN;
+		_x86_wrmsr(ARC_MSR_APIC_BASE, base);
+
+		base |= APIC_BASE_EXTD;
+		_x86_wrmsr(ARC_MSR_APIC_BASE, base);
+	}
+
+	if ((base & (APIC_BASE_EN | APIC_BASE_EXTD)) == (APIC_BASE_EN | APIC_BASE_EXTD)) {
+		_boot_meta.apic_mode = ARC_APIC_X2APIC;
+		_boot_meta.bsp_apic_id = _x86_rdmsr(ARC_MSR_X2APIC_ID);
+	} else {
+		_boot_meta.apic_mode = ARC_APIC_XAPIC;
+		_boot_meta.bsp_apic_id = (ebx >> 24) & 0xFF;
+	}
+
+	ARC_DEBUG(INFO, "BSP APIC ID %d, %s mode\n", _boot_meta.bsp_apic_id, _boot_meta.apic_mode == ARC_APIC_X2APIC ? "x2APIC" : "xAPIC");
+
+	return 0;
+}
+
+int apic_add_cpu(uint32_t apic_id) {
+	for (int i = 0; i < apic_id_count; i++) {
+		if (apic_ids[i] == apic_id) {
+			// Listed as both a LAPIC and an x2APIC
+			return -1;
+		}
+	}
+
+	if (apic_id_count >= ARC_APIC_MAX_CPUS) {
+		ARC_DEBUG(WARN, "Ignoring CPU with APIC ID %d, too many CPUs\n", apic_id);
+		return -1;
+	}
+
+	apic_ids[apic_id_count++] = apic_id;
+
+	return 0;
+}
+
+uint32_t apic_cpu_id(int cpu) {
+	return cpu < apic_id_count ? apic_ids[cpu] : _boot_meta.bsp_apic_id;
+}
+
+int create_apic_map() {
+	if (apic_id_count == 0) {
+		// No MADT, the BSP is all there is
+		apic_add_cpu(_boot_meta.bsp_apic_id);
+	}
+
+	uint32_t highest = 0;
+
+	for (int i = 0; i < apic_id_count; i++) {
+		highest = max(highest, apic_ids[i]);
+	}
+
+	if (highest >= ARC_APIC_MAP_MAX) {
+		ARC_DEBUG(WARN, "APIC ID 0x%x is too high for an APIC map\n", highest);
+		return -1;
+	}
+
+	uint32_t len = highest + 1;
+	int pages = ALIGN(len * sizeof(uint32_t), 0x1000) / 0x1000;
+	uint32_t *map = (uint32_t *)Arc_ListContiguousAlloc(&physical_mem, pages);
+
+	if (map == NULL) {
+		ARC_DEBUG(ERR, "Failed to allocate APIC map\n");
+		return -1;
+	}
+
+	fast_memset(map, 0xFF, pages * 0x1000);
+
+	for (int i = 0; i < apic_id_count; i++) {
+		map[apic_ids[i]] = i;
+	}
+
+	_boot_meta.apic_map = (uintptr_t)map;
+	_boot_meta.apic_map_hhdm = _boot_meta.hhdm_vaddr + (uintptr_t)map;
+	_boot_meta.apic_map_len = len;
+
+	ARC_DEBUG(INFO, "APIC map of %d CPU(s), IDs up to %d\n", apic_id_count, highest);
+
+	return 0;
+}
@@ -28,8 +28,11 @@
 #include <cpuid.h>
 #include <arch/x86/cpuid.h>
 #include <arch/x86/sse.h>
+#include <arch/x86/pat.h>
 #include <global.h>
 
+uint32_t cpu_features = 0;
+
 int check_features() {
 	register uint32_t eax;
 	register uint32_t ebx;
@@ -54,7 +57,48 @@ int check_features() {
 		ARC_DEBUG(INFO, "APIC On Chip\n")
 	}
 
+	if (((edx >> 16) & 1) == 1) {
+		cpu_features |= ARC_CPU_FEATURE_PAT;
+	}
+
+	if (((edx >> 26) & 1) == 1) {
+		cpu_features |= ARC_CPU_FEATURE_SSE2;
+	}
+
+	if (((ecx >> 20) & 1) == 1) {
+		cpu_features |= ARC_CPU_FEATURE_SSE42;
+	}
+
+	if (((ecx >> 21) & 1) == 1) {
+		cpu_features |= ARC_CPU_FEATURE_X2APIC;
+	}
+
+	if (((ecx >> 23) & 1) == 1) {
+		cpu_features |= ARC_CPU_FEATURE_POPCNT;
+	}
+
 	init_sse(ecx, edx);
+	init_pat(edx);
+
+	if (max_basic_value >= 0x07) {
+		__cpuid_count(0x07, 0, eax, ebx, ecx, edx);
+
+		if (((ebx >> 5) & 1) == 1) {
+			cpu_features |= ARC_CPU_FEATURE_AVX2;
+		}
+
+		if (((ebx >> 9) & 1) == 1) {
+			cpu_features |= ARC_CPU_FEATURE_ERMS;
+		}
+
+		if (((ebx >> 23) & 1) == 1) {
+			cpu_features |= ARC_CPU_FEATURE_CLFLUSHOPT;
+		}
+
+		if (((ecx >> 16) & 1) == 1) {
+			cpu_features |= ARC_CPU_FEATURE_LA57;
+		}
+	}
 
 	__cpuid(0x80000000, eax, ebx, ecx, edx);
 
@@ -0,0 +1,109 @@
+/**
+ * @file idt64.c
+ *
+ * @author awewsomegamer <awewsomegamer@gmail.com>
+ *
+ * @LICENSE
+ * Arctan-MB2BSP - Multiboot2 Bootstrapper for Arctan Kernel
+ * Copyright (C) 2023-2024 awewsomegamer
+ *
+ * This file is part of Arctan-MB2BSP
+ *
+ * Arctan is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; version 2
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * @DESCRIPTION
+ * 64-bit IDT catching exceptions between entering long mode and the
+ * kernel installing its own IDT.
+*/
+#include <arch/x86/idt64.h>
+#include <arch/x86/gdt.h>
+#include <global.h>
+
+struct idt64_desc {
+	uint16_t limit;
+	uint64_t base;
+}__attribute__((packed));
+struct idt64_desc idt64r;
+
+struct idt64_entry {
+	uint16_t offset1;
+	uint16_t segment;
+	uint8_t ist;
+	uint8_t attrs;
+	uint16_t offset2;
+	uint32_t offset3;
+	uint32_t reserved;
+}__attribute__((packed));
+static struct idt64_entry idt64_entries[32];
+
+struct tss64 {
+	uint32_t reserved0;
+	uint64_t rsp[3];
+	uint64_t reserved1;
+	uint64_t ist[7];
+	uint64_t reserved2;
+	uint16_t reserved3;
+	uint16_t iopb;
+}__attribute__((packed));
+static struct tss64 tss;
+
+static uint8_t stack[ARC_IDT64_STACK_SIZE] __attribute__((aligned(16)));
+
+static struct ARC_CrashRecord early_record = { 0 };
+struct ARC_CrashRecord *crash_record = NULL;
+/// Port exceptions are written to, 0 if none.
+uint16_t idt64_log_port = 0;
+
+/**
+ * Extern assembly IDT stubs, in order of vector.
+ * */
+extern uint8_t _idt64_stubs[];
+/// Size in bytes of each stub.
+#define STUB_SIZE 16
+
+void init_idt64() {
+	for (int i = 0; i < 32; i++) {
+		uint32_t offset = (uintptr_t)&_idt64_stubs[i * STUB_SIZE];
+
+		idt64_entries[i].offset1 = offset & 0xFFFF;
+		idt64_entries[i].offset2 = (offset >> 16) & 0xFFFF;
+		idt64_entries[i].offset3 = 0;
+		idt64_entries[i].segment = 0x18;
+		idt64_entries[i].ist = 1;
+		idt64_entries[i].attrs = 0x8E;
+		idt64_entries[i].reserved = 0;
+	}
+
+	idt64r.limit = sizeof(idt64_entries) - 1;
+	idt64r.base = (uintptr_t)&idt64_entries;
+
+	tss.ist[0] = (uintptr_t)&stack[ARC_IDT64_STACK_SIZE];
+	tss.iopb = sizeof(struct tss64);
+
+	// Available 64-bit TSS, the upper half of the descriptor (base 63:32) stays 0
+	set_gdt_gate(ARC_IDT64_TSS_SELECTOR / 8, (uintptr_t)&tss, sizeof(struct tss64) - 1, 0x89, 0x0);
+	set_gdt_gate(ARC_IDT64_TSS_SELECTOR / 8 + 1, 0, 0, 0, 0);
+
+#ifdef ARC_E9HACK_ENABLE
+	idt64_log_port = 0xE9;
+#endif
+
+	if (crash_record == NULL) {
+		crash_record = &early_record;
+	}
+
+	_boot_meta.crash_record = (uintptr_t)crash_record;
+
+	ARC_DEBUG(INFO, "Prepared 64-bit IDT\n");
+}
@@ -0,0 +1,44 @@
+/**
+ * @file pat.c
+ *
+ * @author awewsomegamer <awewsomegamer@gmail.com>
+ *
+ * @LICENSE
+ * Arctan-MB2BSP - Multiboot2 Bootstrapper for Arctan Kernel
+ * Copyright (C) 2023-2024 awewsomegamer
+ *
+ * This file is part of Arctan-MB2BSP
+ *
+ * Arctan is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; version 2
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * @DESCRIPTION
+ * Called by CPUID to program the PAT.
+*/
+
+#include <arch/x86/msr.h>
+#include <arch/x86/pat.h>
+#include <global.h>
+
+void init_pat(int edx) {
+	if (((edx >> 16) & 1) == 0) {
+		ARC_DEBUG(INFO, "No PAT, WC mappings will be UC\n");
+		return;
+	}
+
+	// Power on default, except PA1 (PWT) is WC instead of WT
+	_x86_wrmsr(ARC_MSR_PAT, ARC_PAT_VALUE);
+	_boot_meta.pat = ARC_PAT_VALUE;
+
+	ARC_DEBUG(INFO, "Programmed PAT to 0x%"PRIx64"\n", (uint64_t)ARC_PAT_VALUE);
+}
@@ -0,0 +1,190 @@
+/**
+ * @file tss.c
+ *
+ * @author awewsomegamer <awewsomegamer@gmail.com>
+ *
+ * @LICENSE
+ * Arctan-MB2BSP - Multiboot2 Bootstrapper for Arctan Kernel
+ * Copyright (C) 2023-2024 awewsomegamer
+ *
+ * This file is part of Arctan-MB2BSP
+ *
+ * Arctan is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; version 2
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * @DESCRIPTION
+ * Per-CPU long mode GDTs, TSSs and stacks for the kernel.
+*/
+#include <arch/x86/tss.h>
+#include <arch/x86/apic.h>
+#include <mm/freelist.h>
+#include <mm/vmm.h>
+#include <elf/elf.h>
+#include <elf/tls.h>
+#include <global.h>
+#include <util.h>
+
+struct tss64 {
+	uint32_t reserved0;
+	uint64_t rsp[3];
+	uint64_t reserved1;
+	uint64_t ist[7];
+	uint64_t reserved2;
+	uint16_t reserved3;
+	uint16_t iopb;
+}__attribute__((packed));
+
+/// Number of GDT entries, the TSS descriptor takes the last two.
+#define GDT_ENTRIES 9
+/// Offset of the TSS in the page holding the GDT.
+#define TSS_OFFSET 0x100
+
+// Return: size of each CPU's kernel stack in bytes
+static uint64_t cpu_stack_size() {
+	uint64_t size = ARC_CPU_STACK_SIZE;
+
+	if (kernel_notes.stack_size != 0) {
+		size = kernel_notes.stack_size;
+	}
+
+	return ALIGN(size, 0x1000);
+}
+
+// Return: pages used by each CPU, guard pages included
+static int cpu_pages() {
+	int stack_pages = cpu_stack_size() / 0x1000;
+	int ist_pages = ALIGN(ARC_IST_STACK_SIZE, 0x1000) / 0x1000;
+
+	// GDT and TSS, then a guard page below every stack
+	return 1 + ARC_CPU_IST_COUNT * (1 + ist_pages) + 1 + stack_pages;
+}
+
+// Return: pages used by the ARC_CPUDesc array
+static int desc_pages(int cpus) {
+	return ALIGN(cpus * sizeof(struct ARC_CPUDesc), 0x1000) / 0x1000;
+}
+
+int cpu_desc_count_tables() {
+	int cpus = max(_boot_meta.cpu_count, 1);
+
+	return count_tables(ARC_CPU_DESC_VADDR, (uint64_t)(desc_pages(cpus) + cpus * cpu_pages()) * 0x1000, 0);
+}
+
+static uint64_t gdt_entry(uint8_t access, uint8_t flags) {
+	// Base 0, limit 0xFFFFF
+	return 0xFFFF | (0xFULL << 48) | ((uint64_t)access << 40) | ((uint64_t)(flags & 0xF) << 52);
+}
+
+// Place a stack of the given pages above the guard page at page
+// Return: vaddr of the top of the stack
+static uint64_t map_stack(uint8_t *region, int page, int pages) {
+	uint64_t vaddr = ARC_CPU_DESC_VADDR + (page + 1) * 0x1000;
+	uint32_t paddr = (uintptr_t)region + (page + 1) * 0x1000;
+
+	Arc_ListFree(&physical_mem, region + page * 0x1000);
+
+	pml4 = map_range(pml4, vaddr, paddr, pages * 0x1000, ARC_VMM_WRITE | ARC_VMM_WB, 0);
+
+	if (pml4 == NULL) {
+		ARC_DEBUG(ERR, "Failed to map stack at 0x%"PRIx64"\n", vaddr);
+		ARC_HANG
+	}
+
+	return vaddr + pages * 0x1000;
+}
+
+static void create_cpu_desc(uint8_t *region, int page, int cpu, struct ARC_CPUDesc *desc) {
+	uint64_t *gdt = (uint64_t *)(region + page * 0x1000);
+	struct tss64 *tss = (struct tss64 *)((uint8_t *)gdt + TSS_OFFSET);
+	uint64_t gdt_vaddr = ARC_CPU_DESC_VADDR + page * 0x1000;
+	uint64_t tss_vaddr = gdt_vaddr + TSS_OFFSET;
+
+	fast_memset(gdt, 0, 0x1000);
+
+	pml4 = map_range(pml4, gdt_vaddr, (uintptr_t)gdt, 0x1000, ARC_VMM_WRITE | ARC_VMM_WB, 0);
+
+	if (pml4 == NULL) {
+		ARC_DEBUG(ERR, "Failed to map GDT at 0x%"PRIx64"\n", gdt_vaddr);
+		ARC_HANG
+	}
+
+	gdt[ARC_GDT_KERNEL_CODE32 / 8] = gdt_entry(0x9A, 0xC);
+	gdt[ARC_GDT_KERNEL_DATA / 8] = gdt_entry(0x92, 0xC);
+	gdt[ARC_GDT_KERNEL_CODE64 / 8] = gdt_entry(0x9A, 0xA);
+	gdt[ARC_GDT_USER_CODE32 / 8] = gdt_entry(0xFA, 0xC);
+	gdt[ARC_GDT_USER_DATA / 8] = gdt_entry(0xF2, 0xC);
+	gdt[ARC_GDT_USER_CODE64 / 8] = gdt_entry(0xFA, 0xA);
+
+	// Available 64-bit TSS, the upper half holds base 63:32
+	uint64_t limit = sizeof(struct tss64) - 1;
+	gdt[ARC_GDT_TSS / 8] = (limit & 0xFFFF) | ((tss_vaddr & 0xFFFFFF) << 16) | (0x89ULL << 40)
+			       | (((limit >> 16) & 0xF) << 48) | (((tss_vaddr >> 24) & 0xFF) << 56);
+	gdt[ARC_GDT_TSS / 8 + 1] = tss_vaddr >> 32;
+
+	tss->iopb = sizeof(struct tss64);
+
+	desc->gdt = gdt_vaddr;
+	desc->gdt_limit = GDT_ENTRIES * 8 - 1;
+	desc->tss_selector = ARC_GDT_TSS;
+	desc->tss = tss_vaddr;
+	desc->apic_id = apic_cpu_id(cpu);
+	desc->fs_base = tls_pointer(cpu);
+
+	int ist_pages = ALIGN(ARC_IST_STACK_SIZE, 0x1000) / 0x1000;
+	page++;
+
+	for (int i = 0; i < ARC_CPU_IST_COUNT; i++) {
+		desc->ist[i] = map_stack(region, page, ist_pages);
+		tss->ist[i] = desc->ist[i];
+		page += 1 + ist_pages;
+	}
+
+	desc->stack = map_stack(region, page, cpu_stack_size() / 0x1000);
+	tss->rsp[0] = desc->stack;
+}
+
+int create_cpu_descs() {
+	int cpus = max(_boot_meta.cpu_count, 1);
+	int first = desc_pages(cpus);
+	int pages = first + cpus * cpu_pages();
+
+	uint8_t *region = (uint8_t *)Arc_ListContiguousAlignedAlloc(&physical_mem, pages, 0x1000);
+
+	if (region == NULL) {
+		ARC_DEBUG(ERR, "Failed to allocate %d pages for CPU descriptors\n", pages);
+		return -1;
+	}
+
+	struct ARC_CPUDesc *descs = (struct ARC_CPUDesc *)region;
+
+	fast_memset(descs, 0, first * 0x1000);
+
+	pml4 = map_range(pml4, ARC_CPU_DESC_VADDR, (uintptr_t)region, first * 0x1000, ARC_VMM_WRITE | ARC_VMM_WB, 0);
+
+	if (pml4 == NULL) {
+		ARC_DEBUG(ERR, "Failed to map CPU descriptors\n");
+		ARC_HANG
+	}
+
+	for (int i = 0; i < cpus; i++) {
+		create_cpu_desc(region, first + i * cpu_pages(), i, &descs[i]);
+	}
+
+	_boot_meta.cpu_desc = ARC_CPU_DESC_VADDR;
+	_boot_meta.cpu_desc_paddr = (uintptr_t)region;
+	_boot_meta.cpu_desc_count = cpus;
+
+	ARC_DEBUG(INFO, "Created descriptor tables and stacks for %d CPU(s) at 0x%"PRIxPTR" (%d pages)\n", cpus, (uintptr_t)region, pages);
+
+	return 0;
+}
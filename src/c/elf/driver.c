@@ -0,0 +1,543 @@
+/**
+ * @file driver.c
+ *
+ * @author awewsomegamer <awewsomegamer@gmail.com>
+ *
+ * @LICENSE
+ * Arctan-MB2BSP - Multiboot2 Bootstrapper for Arctan Kernel
+ * Copyright (C) 2023-2024 awewsomegamer
+ *
+ * This file is part of Arctan-MB2BSP
+ *
+ * Arctan is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; version 2
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * @DESCRIPTION
+ * Loader for relocatable ELF driver modules.
+*/
+#include <elf/driver.h>
+#include <elf/elf.h>
+#include <elf/elf64.h>
+#include <mm/freelist.h>
+#include <mm/vmm.h>
+#include <mm/pmm.h>
+#include <global.h>
+#include <util.h>
+
+struct driver {
+	uint8_t *file;
+	uint32_t file_size;
+	char name[ARC_DRIVER_NAME_LEN];
+	/// Address of each section, 0 if it is not allocated.
+	uint64_t *sections;
+	int section_pages;
+	uint64_t base;
+	uint64_t data_offset;
+	uint64_t size;
+};
+
+static struct driver drivers[ARC_DRIVER_MAX] = { 0 };
+static int driver_total = 0;
+
+/// Kernel symbols by name hash, indices into _boot_meta.sym_table.
+static uint32_t *exports = NULL;
+static uint32_t export_mask = 0;
+static int export_pages = 0;
+
+static int is_driver(uint8_t *file, uint64_t size) {
+	struct Elf64_Ehdr *header = (struct Elf64_Ehdr *)file;
+
+	if (size < sizeof(struct Elf64_Ehdr) || file[0] != 0x7F || file[1] != 'E' || file[2] != 'L' || file[3] != 'F') {
+		return 0;
+	}
+
+	return header->e_type == ET_REL && header->e_machine == EM_X86_64
+	       && header->e_shoff + (uint64_t)header->e_shnum * sizeof(struct Elf64_Shdr) <= size;
+}
+
+int driver_add(char *cmdline, uint64_t paddr, uint64_t size) {
+	char *prefix = ARC_DRIVER_PREFIX;
+	int i = 0;
+
+	for (; prefix[i] != 0; i++) {
+		if (cmdline[i] != prefix[i]) {
+			return -1;
+		}
+	}
+
+	if (driver_total >= ARC_DRIVER_MAX) {
+		ARC_DEBUG(WARN, "\tToo many drivers, ignoring\n");
+		return 0;
+	}
+
+	if (paddr + size > 0x100000000ULL || !is_driver((uint8_t *)((uint32_t)paddr), size)) {
+		ARC_DEBUG(WARN, "\tNot a relocatable x86-64 ELF, ignoring\n");
+		return 0;
+	}
+
+	struct driver *driver = &drivers[driver_total++];
+
+	driver->file = (uint8_t *)((uint32_t)paddr);
+	driver->file_size = size;
+
+	for (int j = 0; j < ARC_DRIVER_NAME_LEN - 1 && cmdline[i + j] != 0; j++) {
+		driver->name[j] = cmdline[i + j];
+	}
+
+	ARC_DEBUG(INFO, "\tFound driver %s\n", driver->name);
+
+	return 0;
+}
+
+// Return: address of the first 2 MiB boundary after the kernel's image, 0 if
+// the kernel is not present
+static uint64_t drivers_base() {
+	void *file = (void *)((uint32_t)_boot_meta.kernel_elf);
+	uint64_t vaddr = 0, size = 0, end = 0;
+	int writable = 0;
+	int ret = 0;
+
+	if (file == NULL) {
+		return 0;
+	}
+
+	for (int i = 0; (ret = elf_segment(file, i, &vaddr, &size, &writable)) >= 0; i++) {
+		if (ret == 0) {
+			end = max(end, vaddr + size);
+		}
+	}
+
+	return ALIGN(end, 0x200000);
+}
+
+// Lay out the allocated sections of a driver from base, read-only ones
+// first, recording their addresses if driver->sections is set
+// Return: page aligned size of the image
+static uint64_t layout_driver(struct driver *driver, uint64_t base) {
+	struct Elf64_Ehdr *header = (struct Elf64_Ehdr *)driver->file;
+	struct Elf64_Shdr *sections = (struct Elf64_Shdr *)(driver->file + header->e_shoff);
+	uint64_t offset = 0;
+
+	for (int writable = 0; writable < 2; writable++) {
+		for (int i = 0; i < header->e_shnum; i++) {
+			if (!(sections[i].sh_flags & SHF_ALLOC) || ((sections[i].sh_flags & SHF_WRITE) != 0) != writable) {
+				continue;
+			}
+
+			uint64_t align = max(sections[i].sh_addralign, 1);
+			offset = ALIGN(offset, align);
+
+			if (driver->sections != NULL) {
+				driver->sections[i] = base + offset;
+			}
+
+			offset += sections[i].sh_size;
+		}
+
+		offset = ALIGN(offset, 0x1000);
+
+		if (!writable) {
+			driver->data_offset = offset;
+		}
+	}
+
+	return offset;
+}
+
+int driver_count_tables() {
+	uint64_t base = drivers_base();
+	uint64_t size = 0;
+
+	if (driver_total == 0 || base == 0) {
+		return 0;
+	}
+
+	for (int i = 0; i < driver_total; i++) {
+		size += layout_driver(&drivers[i], 0);
+	}
+
+	return count_tables(base, size, 0);
+}
+
+// Hash every defined global kernel symbol by name
+// Return 0: success
+static int build_exports() {
+	struct Elf64_Sym *symbols = (struct Elf64_Sym *)((uint32_t)_boot_meta.sym_table);
+	char *strings = (char *)((uint32_t)_boot_meta.str_table);
+	uint32_t count = _boot_meta.sym_table_size / sizeof(struct Elf64_Sym);
+	uint32_t slots = 1;
+
+	while (slots < count * 2) {
+		slots <<= 1;
+	}
+
+	export_pages = ALIGN(slots * sizeof(uint32_t), 0x1000) / 0x1000;
+	exports = (uint32_t *)Arc_ListContiguousAlloc(&physical_mem, export_pages);
+
+	if (exports == NULL) {
+		ARC_DEBUG(ERR, "Failed to allocate kernel symbol hash table\n");
+		return -1;
+	}
+
+	fast_memset(exports, 0xFF, export_pages * 0x1000);
+	export_mask = slots - 1;
+
+	for (uint32_t i = 0; i < count; i++) {
+		int bind = ELF64_ST_BIND(symbols[i].st_info);
+
+		if ((bind != STB_GLOBAL && bind != STB_WEAK) || symbols[i].st_shndx == SHN_UNDEF) {
+			continue;
+		}
+
+		uint32_t slot = name_hash(strings + symbols[i].st_name) & export_mask;
+
+		while (exports[slot] != 0xFFFFFFFF) {
+			slot = (slot + 1) & export_mask;
+		}
+
+		exports[slot] = i;
+	}
+
+	return 0;
+}
+
+static struct Elf64_Sym *find_export(char *name) {
+	struct Elf64_Sym *symbols = (struct Elf64_Sym *)((uint32_t)_boot_meta.sym_table);
+	char *strings = (char *)((uint32_t)_boot_meta.str_table);
+
+	if (exports == NULL) {
+		return NULL;
+	}
+
+	for (uint32_t slot = name_hash(name) & export_mask; exports[slot] != 0xFFFFFFFF; slot = (slot + 1) & export_mask) {
+		if (names_equal(strings + symbols[exports[slot]].st_name, name)) {
+			return &symbols[exports[slot]];
+		}
+	}
+
+	return NULL;
+}
+
+// Return 0: the value of the symbol was put into value
+static int symbol_value(struct driver *driver, struct Elf64_Sym *symbol, char *strings, uint64_t *value) {
+	struct Elf64_Ehdr *header = (struct Elf64_Ehdr *)driver->file;
+
+	if (symbol->st_shndx == SHN_UNDEF) {
+		struct Elf64_Sym *export = find_export(strings + symbol->st_name);
+
+		if (export != NULL) {
+			*value = export->st_value;
+			return 0;
+		}
+
+		if (ELF64_ST_BIND(symbol->st_info) == STB_WEAK) {
+			*value = 0;
+			return 0;
+		}
+
+		ARC_DEBUG(ERR, "%s: undefined symbol %s\n", driver->name, strings + symbol->st_name);
+		return -1;
+	}
+
+	if (symbol->st_shndx == SHN_ABS) {
+		*value = symbol->st_value;
+		return 0;
+	}
+
+	if (symbol->st_shndx >= header->e_shnum || driver->sections[symbol->st_shndx] == 0) {
+		// Includes SHN_COMMON, drivers must be built with -fno-common
+		ARC_DEBUG(ERR, "%s: symbol %s is not in an allocated section\n", driver->name, strings + symbol->st_name);
+		return -1;
+	}
+
+	*value = driver->sections[symbol->st_shndx] + symbol->st_value;
+
+	return 0;
+}
+
+// Apply the relocations of a driver to its image, or only check that
+// they can be applied if image is NULL
+// Return 0: success
+static int relocate_driver(struct driver *driver, uint8_t *image) {
+	struct Elf64_Ehdr *header = (struct Elf64_Ehdr *)driver->file;
+	struct Elf64_Shdr *sections = (struct Elf64_Shdr *)(driver->file + header->e_shoff);
+
+	for (int i = 0; i < header->e_shnum; i++) {
+		if (sections[i].sh_type == SHT_REL) {
+			ARC_DEBUG(ERR, "%s: SHT_REL relocations are not supported\n", driver->name);
+			return -1;
+		}
+
+		// Relocations of unallocated sections, such as debug information, are skipped
+		if (sections[i].sh_type != SHT_RELA || sections[i].sh_info >= header->e_shnum
+		    || driver->sections[sections[i].sh_info] == 0 || sections[i].sh_link >= header->e_shnum) {
+			continue;
+		}
+
+		struct Elf64_Shdr *target = &sections[sections[i].sh_info];
+		struct Elf64_Shdr *symtab = &sections[sections[i].sh_link];
+		struct Elf64_Sym *symbols = (struct Elf64_Sym *)(driver->file + symtab->sh_offset);
+		char *strings = (char *)(driver->file + sections[symtab->sh_link].sh_offset);
+		struct Elf64_Rela *relas = (struct Elf64_Rela *)(driver->file + sections[i].sh_offset);
+		int count = sections[i].sh_size / sizeof(struct Elf64_Rela);
+
+		for (int j = 0; j < count; j++) {
+			uint32_t type = ELF64_R_TYPE(relas[j].r_info);
+			uint64_t place = driver->sections[sections[i].sh_info] + relas[j].r_offset;
+			uint64_t value = 0;
+
+			if (type == R_X86_64_NONE) {
+				continue;
+			}
+
+			if (symbol_value(driver, &symbols[ELF64_R_SYM(relas[j].r_info)], strings, &value) != 0) {
+				return -1;
+			}
+
+			value += relas[j].r_addend;
+
+			uint64_t size = 4;
+			int overflow = 0;
+
+			switch (type) {
+			case R_X86_64_64: {
+				size = 8;
+				break;
+			}
+
+			case R_X86_64_PC64: {
+				value -= place;
+				size = 8;
+				break;
+			}
+
+			case R_X86_64_PC32:
+			case R_X86_64_PLT32: {
+				value -= place;
+				overflow = (int64_t)value != (int32_t)value;
+				break;
+			}
+
+			case R_X86_64_32: {
+				overflow = value != (uint32_t)value;
+				break;
+			}
+
+			case R_X86_64_32S: {
+				overflow = (int64_t)value != (int32_t)value;
+				break;
+			}
+
+			default: {
+				ARC_DEBUG(ERR, "%s: unsupported relocation type %d\n", driver->name, type);
+				return -1;
+			}
+			}
+
+			if (overflow || relas[j].r_offset + size > target->sh_size) {
+				ARC_DEBUG(ERR, "%s: bad relocation at 0x%"PRIx64"\n", driver->name, place);
+				return -1;
+			}
+
+			if (image != NULL && target->sh_type != SHT_NOBITS) {
+				void *at = image + (place - driver->base);
+
+				if (size == 8) {
+					*(uint64_t *)at = value;
+				} else {
+					*(uint32_t *)at = (uint32_t)value;
+				}
+			}
+		}
+	}
+
+	return 0;
+}
+
+// Return: address of the driver's ARC_DRIVER_INIT, 0 if it has none
+static uint64_t driver_init(struct driver *driver) {
+	struct Elf64_Ehdr *header = (struct Elf64_Ehdr *)driver->file;
+	struct Elf64_Shdr *sections = (struct Elf64_Shdr *)(driver->file + header->e_shoff);
+
+	for (int i = 0; i < header->e_shnum; i++) {
+		if (sections[i].sh_type != SHT_SYMTAB) {
+			continue;
+		}
+
+		struct Elf64_Sym *symbols = (struct Elf64_Sym *)(driver->file + sections[i].sh_offset);
+		char *strings = (char *)(driver->file + sections[sections[i].sh_link].sh_offset);
+		int count = sections[i].sh_size / sizeof(struct Elf64_Sym);
+		uint64_t value = 0;
+
+		for (int j = 0; j < count; j++) {
+			if (ELF64_ST_BIND(symbols[j].st_info) == STB_GLOBAL && symbols[j].st_shndx != SHN_UNDEF
+			    && names_equal(strings + symbols[j].st_name, ARC_DRIVER_INIT)
+			    && symbol_value(driver, &symbols[j], strings, &value) == 0) {
+				return value;
+			}
+		}
+	}
+
+	return 0;
+}
+
+// Copy the driver's sections into its image and relocate them
+static void copy_driver(struct driver *driver, uint8_t *image) {
+	struct Elf64_Ehdr *header = (struct Elf64_Ehdr *)driver->file;
+	struct Elf64_Shdr *sections = (struct Elf64_Shdr *)(driver->file + header->e_shoff);
+
+	for (int i = 0; i < header->e_shnum; i++) {
+		if (driver->sections[i] == 0 || sections[i].sh_type == SHT_NOBITS) {
+			continue;
+		}
+
+		fast_memcpy(image + (driver->sections[i] - driver->base), driver->file + sections[i].sh_offset, sections[i].sh_size);
+	}
+
+	relocate_driver(driver, image);
+}
+
+static void free_driver(struct driver *driver) {
+	if (driver->sections != NULL) {
+		Arc_ListContiguousFree(&physical_mem, driver->sections, driver->section_pages);
+		driver->sections = NULL;
+	}
+}
+
+int load_drivers() {
+	if (driver_total == 0) {
+		return 0;
+	}
+
+	uint64_t base = drivers_base();
+	int err = 0;
+
+	if (base == 0 || (_boot_meta.sym_table != 0 && build_exports() != 0)) {
+		return -1;
+	}
+
+	// Lay out every driver and check all of their relocations first, so
+	// the drivers which cannot be loaded take no space
+	uint64_t size = 0;
+	int count = 0;
+
+	for (int i = 0; i < driver_total; i++) {
+		struct driver *driver = &drivers[i];
+		struct Elf64_Ehdr *header = (struct Elf64_Ehdr *)driver->file;
+
+		driver->section_pages = ALIGN(header->e_shnum * sizeof(uint64_t), 0x1000) / 0x1000;
+		driver->sections = (uint64_t *)Arc_ListContiguousAlloc(&physical_mem, driver->section_pages);
+
+		if (driver->sections == NULL) {
+			ARC_DEBUG(ERR, "%s: failed to allocate section table\n", driver->name);
+			err = -1;
+			continue;
+		}
+
+		fast_memset(driver->sections, 0, driver->section_pages * 0x1000);
+
+		driver->base = base + size;
+		driver->size = layout_driver(driver, driver->base);
+
+		if (relocate_driver(driver, NULL) != 0) {
+			free_driver(driver);
+			err = -1;
+			continue;
+		}
+
+		size += driver->size;
+		count++;
+	}
+
+	int image_pages = size / 0x1000;
+	int table_pages = ALIGN(count * sizeof(struct ARC_DriverModule), 0x1000) / 0x1000;
+	uint8_t *image = NULL;
+
+	if (count != 0) {
+		image = (uint8_t *)Arc_ListContiguousAlignedAlloc(&physical_mem, image_pages + table_pages, 0x1000);
+
+		if (image == NULL) {
+			ARC_DEBUG(ERR, "Failed to allocate %d pages for drivers\n", image_pages + table_pages);
+			count = 0;
+			err = -1;
+		}
+	}
+
+	if (image != NULL) {
+		struct ARC_DriverModule *table = (struct ARC_DriverModule *)(image + size);
+		int j = 0;
+
+		fast_memset(image, 0, (image_pages + table_pages) * 0x1000);
+
+		for (int i = 0; i < driver_total; i++) {
+			struct driver *driver = &drivers[i];
+
+			if (driver->sections == NULL) {
+				continue;
+			}
+
+			uint8_t *driver_image = image + (driver->base - base);
+			copy_driver(driver, driver_image);
+
+			if (driver->data_offset != 0) {
+				pml4 = map_range(pml4, driver->base, (uintptr_t)driver_image, driver->data_offset, ARC_VMM_WB, 0);
+			}
+
+			if (pml4 != NULL && driver->size > driver->data_offset) {
+				pml4 = map_range(pml4, driver->base + driver->data_offset, (uintptr_t)driver_image + driver->data_offset,
+						 driver->size - driver->data_offset, ARC_VMM_WRITE | ARC_VMM_WB, 0);
+			}
+
+			if (pml4 == NULL) {
+				ARC_DEBUG(ERR, "Failed to map driver %s\n", driver->name);
+				ARC_HANG
+			}
+
+			table[j].base = driver->base;
+			table[j].paddr = (uintptr_t)driver_image;
+			table[j].size = driver->size;
+			table[j].data_offset = driver->data_offset;
+			table[j].init = driver_init(driver);
+			fast_memcpy(table[j].name, driver->name, ARC_DRIVER_NAME_LEN);
+
+			ARC_DEBUG(INFO, "Loaded driver %s at 0x%"PRIx64" (0x%"PRIx64" B)\n", driver->name, driver->base, driver->size);
+
+			j++;
+		}
+
+		_boot_meta.drivers = (uintptr_t)table;
+		_boot_meta.drivers_hhdm = _boot_meta.hhdm_vaddr + (uintptr_t)table;
+	}
+
+	for (int i = 0; i < driver_total; i++) {
+		free_driver(&drivers[i]);
+	}
+
+	_boot_meta.driver_count = count;
+
+	if (exports != NULL) {
+		Arc_ListContiguousFree(&physical_mem, exports, export_pages);
+		exports = NULL;
+	}
+
+	// Everything has been copied out of the modules
+	for (int i = 0; i < driver_total; i++) {
+		if (pmm_release((uintptr_t)drivers[i].file, drivers[i].file_size) != 0) {
+			ARC_DEBUG(WARN, "Could not release driver module %s\n", drivers[i].name);
+		}
+	}
+
+	driver_total = 0;
+
+	return err;
+}
@@ -29,19 +29,8 @@
 #include <mm/freelist.h>
 #include <elf/elf.h>
 #include <mm/vmm.h>
-
-#define SHT_NULL 0
-#define SHT_PROGBITS 1
-#define SHT_SYMTAB 2
-#define SHT_STRTAB 3
-#define SHT_RELA 4
-#define SHT_HASH 5
-#define SHT_DYNAMIC 6
-#define SHT_NOTE 7
-#define SHT_NOBITS 8
-#define SHT_REL 9
-#define SHT_SHLIB 10
-#define SHT_DYNSYM 11
+#include <arch/x86/cpuid.h>
+#include <elf/elf64.h>
 
 static const char *section_types[] = {
 	[SHT_NULL] = "NULL",
@@ -58,74 +47,557 @@ static const char *section_types[] = {
 	[SHT_DYNSYM] = "DYNSYM",
 };
 
-typedef uint64_t Elf64_Addr;
-typedef uint64_t Elf64_Off;
-typedef uint16_t Elf64_Half;
-typedef uint32_t Elf64_Word;
-typedef uint32_t Elf64_Sword;
-typedef uint64_t Elf64_Xword;
-typedef uint64_t Elf64_Sxword;
-
-struct Elf64_Ehdr {
-	unsigned char e_ident[16]; /* ELF identification */
-	Elf64_Half e_type; /* Object file type */
-	Elf64_Half e_machine; /* Machine type */
-	Elf64_Word e_version; /* Object file version */
-	Elf64_Addr e_entry; /* Entry point address */
-	Elf64_Off e_phoff; /* Program header offset */
-	Elf64_Off e_shoff; /* Section header offset */
-	Elf64_Word e_flags; /* Processor-specific flags */
-	Elf64_Half e_ehsize; /* ELF header size */
-	Elf64_Half e_phentsize; /* Size of program header entry */
-	Elf64_Half e_phnum; /* Number of program header entries */
-	Elf64_Half e_shentsize; /* Size of section header entry */
-	Elf64_Half e_shnum; /* Number of section header entries */
-	Elf64_Half e_shstrndx; /* Section name string table index */
-}__attribute__((packed));
-
-struct Elf64_Shdr {
-	Elf64_Word sh_name; /* Section name */
-	Elf64_Word sh_type; /* Section type */
-	Elf64_Xword sh_flags; /* Section attributes */
-	Elf64_Addr sh_addr; /* Virtual address in memory */
-	Elf64_Off sh_offset; /* Offset in file */
-	Elf64_Xword sh_size; /* Size of section */
-	Elf64_Word sh_link; /* Link to other section */
-	Elf64_Word sh_info; /* Miscellaneous information */
-	Elf64_Xword sh_addralign; /* Address alignment boundary */
-	Elf64_Xword sh_entsize; /* Size of entries, if section has table */
-}__attribute__((packed));
-
-struct Elf64_Sym {
-	Elf64_Word st_name; /* Symbol name */
-	unsigned char st_info; /* Type and Binding attributes */
-	unsigned char st_other; /* Reserved */
-	Elf64_Half st_shndx; /* Section table index */
-	Elf64_Addr st_value; /* Symbol value */
-	Elf64_Xword st_size; /* Size of object (e.g., common) */
-}__attribute__((packed));
-
-struct Elf64_Rel {
-	Elf64_Addr r_offset; /* Address of reference */
-	Elf64_Xword r_info; /* Symbol index and type of relocation */
-}__attribute__((packed));
-
-struct Elf64_Rela {
-	Elf64_Addr r_offset; /* Address of reference */
-	Elf64_Xword r_info; /* Symbol index and type of relocation */
-	Elf64_Sxword r_addend; /* Constant part of expression */
-}__attribute__((packed));
-
-struct Elf64_Phdr {
-	Elf64_Word p_type; /* Type of segment */
-	Elf64_Word p_flags; /* Segment attributes */
-	Elf64_Off p_offset; /* Offset in file */
-	Elf64_Addr p_vaddr; /* Virtual address in memory */
-	Elf64_Addr p_paddr; /* Reserved */
-	Elf64_Xword p_filesz; /* Size of segment in file */
-	Elf64_Xword p_memsz; /* Size of segment in memory */
-	Elf64_Xword p_align; /* Alignment of segment */
-}__attribute__((packed));
+struct ARC_KernelNotes kernel_notes = { 0 };
+
+static int is_elf(struct Elf64_Ehdr *header) {
+	return header->e_ident[0] == 0x7F && header->e_ident[1] == 'E' &&
+	       header->e_ident[2] == 'L' && header->e_ident[3] == 'F';
+}
+
+// Copy all PT_LOAD segments into one 2 MiB aligned, physically
+// contiguous extent, so large pages can be used for them
+// Return 0: success
+static int relocate_segments(uint64_t *pml4, void *file, struct Elf64_Ehdr *header) {
+	struct Elf64_Phdr *program_headers = (struct Elf64_Phdr *)(file + header->e_phoff);
+	uint64_t lowest = (uint64_t)-1;
+	uint64_t highest = 0;
+
+	for (int i = 0; i < header->e_phnum; i++) {
+		if (program_headers[i].p_type != PT_LOAD || program_headers[i].p_memsz == 0) {
+			continue;
+		}
+
+		lowest = min(lowest, program_headers[i].p_vaddr & ~0xFFFULL);
+		highest = max(highest, ALIGN(program_headers[i].p_vaddr + program_headers[i].p_memsz, 0x1000));
+	}
+
+	if (lowest >= highest) {
+		ARC_DEBUG(ERR, "No PT_LOAD segments\n");
+		return -1;
+	}
+
+	// Keep the physical extent at the same offset into a 2 MiB page
+	// as the image, so that vaddr and paddr line up for large pages
+	int phase = (lowest & 0x1FFFFF) / 0x1000;
+	int pages = (highest - lowest) / 0x1000;
+	void *extent = Arc_ListContiguousAlignedAlloc(&physical_mem, phase + pages, 0x200000);
+
+	if (extent == NULL) {
+		ARC_DEBUG(ERR, "Failed to allocate 0x%x pages for the kernel image\n", pages);
+		return -1;
+	}
+
+	if (phase > 0) {
+		Arc_ListContiguousFree(&physical_mem, extent, phase);
+	}
+
+	uint64_t image = (uintptr_t)extent + phase * 0x1000;
+
+	ARC_DEBUG(INFO, "Relocating image 0x%"PRIx64" -> 0x%"PRIx64" (%d pages) to 0x%"PRIx64"\n", lowest, highest, pages, image);
+
+	// Zero the whole extent up front, segments may share a page and
+	// zeroing around one would wipe what was copied for the other
+	fast_memset((void *)((uint32_t)image), 0, pages * 0x1000);
+
+	for (int i = 0; i < header->e_phnum; i++) {
+		struct Elf64_Phdr segment = program_headers[i];
+
+		if (segment.p_type != PT_LOAD || segment.p_memsz == 0) {
+			continue;
+		}
+
+		uint64_t vbase = segment.p_vaddr & ~0xFFFULL;
+		uint64_t vceil = ALIGN(segment.p_vaddr + segment.p_memsz, 0x1000);
+		uint32_t paddr = image + (segment.p_vaddr - lowest);
+		uint32_t pbase = image + (vbase - lowest);
+
+		ARC_DEBUG(INFO, "Segment %d: 0x%"PRIx64" (0x%"PRIx64" B in file, 0x%"PRIx64" B in memory) to 0x%"PRIx32"\n", i, segment.p_vaddr, segment.p_filesz, segment.p_memsz, paddr);
+
+		fast_memcpy((void *)paddr, file + segment.p_offset, segment.p_filesz);
+
+		uint64_t flags = (segment.p_flags & PF_W) ? ARC_VMM_WRITE : 0;
+
+		// Segments sharing a page share the same frame, so overwriting is fine
+		pml4 = map_range(pml4, vbase, pbase, vceil - vbase, flags, 1);
+
+		if (pml4 == NULL) {
+			ARC_DEBUG(ERR, "Failed to map segment %d\n", i);
+			return -1;
+		}
+	}
+
+	return 0;
+}
+
+// Allocate, zero and map a NOBITS section as one extent
+// Return 0: success
+static int load_nobits(uint64_t *pml4, uint64_t vaddr, uint64_t size) {
+	uint64_t end = vaddr + size;
+	uint64_t paddr = 0;
+
+	if ((vaddr & 0xFFF) != 0 && translate(pml4, vaddr, &paddr) == 0) {
+		// The first page is shared with the previous section, which is
+		// mapped in place, give it a copy so its tail can be zeroed
+		// without touching the file
+		uint32_t offset = vaddr & 0xFFF;
+		void *page = Arc_ListAlloc(&physical_mem);
+
+		if (page == NULL) {
+			return -1;
+		}
+
+		fast_memcpy(page, (void *)((uint32_t)paddr - offset), offset);
+		fast_memset(page + offset, 0, 0x1000 - offset);
+
+		if (map_page(pml4, vaddr, (uintptr_t)page, ARC_VMM_WRITE, 1) == NULL) {
+			return -1;
+		}
+
+		vaddr = ALIGN(vaddr, 0x1000);
+	}
+
+	if (vaddr >= end) {
+		return 0;
+	}
+
+	vaddr &= ~0xFFFULL;
+
+	// Keep the extent at the same offset into a 2 MiB page as vaddr,
+	// so large pages can be used
+	int phase = (vaddr & 0x1FFFFF) / 0x1000;
+	int pages = (ALIGN(end, 0x1000) - vaddr) / 0x1000;
+	void *extent = Arc_ListContiguousAlignedAlloc(&physical_mem, phase + pages, 0x200000);
+
+	if (extent == NULL) {
+		// Settle for contiguous
+		phase = 0;
+		extent = Arc_ListContiguousAlignedAlloc(&physical_mem, pages, 0x1000);
+	}
+
+	if (extent == NULL) {
+		ARC_DEBUG(ERR, "\tFailed to allocate %d pages\n", pages);
+		return -1;
+	}
+
+	if (phase > 0) {
+		Arc_ListContiguousFree(&physical_mem, extent, phase);
+		extent += phase * 0x1000;
+	}
+
+	ARC_DEBUG(INFO, "\tAllocated %d pages at 0x%"PRIxPTR"\n", pages, (uintptr_t)extent);
+
+	fast_memset(extent, 0, pages * 0x1000);
+
+	if (map_range(pml4, vaddr, (uintptr_t)extent, pages * 0x1000, ARC_VMM_WRITE, 0) == NULL) {
+		return -1;
+	}
+
+	return 0;
+}
+
+static void sift_down(struct ARC_KernSym *index, int root, int count) {
+	while ((root * 2) + 1 < count) {
+		int child = (root * 2) + 1;
+
+		if (child + 1 < count && index[child + 1].addr > index[child].addr) {
+			child++;
+		}
+
+		if (index[root].addr >= index[child].addr) {
+			return;
+		}
+
+		struct ARC_KernSym tmp = index[root];
+		index[root] = index[child];
+		index[child] = tmp;
+
+		root = child;
+	}
+}
+
+// Heapsort the index by address
+static void sort_symbols(struct ARC_KernSym *index, int count) {
+	for (int i = (count / 2) - 1; i >= 0; i--) {
+		sift_down(index, i, count);
+	}
+
+	for (int i = count - 1; i > 0; i--) {
+		struct ARC_KernSym tmp = index[0];
+		index[0] = index[i];
+		index[i] = tmp;
+
+		sift_down(index, 0, i);
+	}
+}
+
+// Copy .symtab and .strtab out of the file and build an
+// index of function symbols sorted by address
+// Return 0: success
+static int load_symbols(void *file, struct Elf64_Ehdr *header) {
+	struct Elf64_Shdr *section_headers = ((struct Elf64_Shdr *)(file + header->e_shoff));
+	struct Elf64_Shdr *symtab = NULL;
+
+	for (int i = 0; i < header->e_shnum; i++) {
+		if (section_headers[i].sh_type == SHT_SYMTAB) {
+			symtab = &section_headers[i];
+			break;
+		}
+	}
+
+	if (symtab == NULL || symtab->sh_link >= header->e_shnum) {
+		return -1;
+	}
+
+	struct Elf64_Shdr *strtab = &section_headers[symtab->sh_link];
+	struct Elf64_Sym *symbols = (struct Elf64_Sym *)(file + symtab->sh_offset);
+	int count = symtab->sh_size / sizeof(struct Elf64_Sym);
+	int functions = 0;
+
+	for (int i = 0; i < count; i++) {
+		if (ELF64_ST_TYPE(symbols[i].st_info) == STT_FUNC && symbols[i].st_shndx != 0) {
+			functions++;
+		}
+	}
+
+	uint32_t sym_size = ALIGN((uint32_t)symtab->sh_size, 0x1000);
+	uint32_t str_size = ALIGN((uint32_t)strtab->sh_size, 0x1000);
+	uint32_t index_size = ALIGN(functions * sizeof(struct ARC_KernSym), 0x1000);
+	void *base = Arc_ListContiguousAlignedAlloc(&physical_mem, (sym_size + str_size + index_size) / 0x1000, 0x1000);
+
+	if (base == NULL) {
+		return -1;
+	}
+
+	void *sym_copy = base;
+	void *str_copy = base + sym_size;
+	struct ARC_KernSym *index = (struct ARC_KernSym *)(base + sym_size + str_size);
+
+	fast_memcpy(sym_copy, symbols, symtab->sh_size);
+	fast_memcpy(str_copy, file + strtab->sh_offset, strtab->sh_size);
+
+	int j = 0;
+	for (int i = 0; i < count; i++) {
+		if (ELF64_ST_TYPE(symbols[i].st_info) != STT_FUNC || symbols[i].st_shndx == 0) {
+			continue;
+		}
+
+		index[j].addr = symbols[i].st_value;
+		index[j].size = symbols[i].st_size;
+		index[j].name = symbols[i].st_name;
+		j++;
+	}
+
+	sort_symbols(index, functions);
+
+	_boot_meta.sym_table = (uintptr_t)sym_copy;
+	_boot_meta.sym_table_size = symtab->sh_size;
+	_boot_meta.str_table = (uintptr_t)str_copy;
+	_boot_meta.str_table_hhdm = _boot_meta.hhdm_vaddr + (uintptr_t)str_copy;
+	_boot_meta.str_table_size = strtab->sh_size;
+	_boot_meta.sym_index = (uintptr_t)index;
+	_boot_meta.sym_index_hhdm = _boot_meta.hhdm_vaddr + (uintptr_t)index;
+	_boot_meta.sym_index_len = functions;
+
+	ARC_DEBUG(INFO, "Indexed %d function symbols at 0x%"PRIxPTR"\n", functions, (uintptr_t)index);
+
+	return 0;
+}
+
+int elf_count_tables(void *file) {
+	struct Elf64_Ehdr *header = (struct Elf64_Ehdr *)file;
+
+	if (!is_elf(header)) {
+		return 0;
+	}
+
+	struct Elf64_Phdr *program_headers = (struct Elf64_Phdr *)(file + header->e_phoff);
+	int count = 0;
+
+	for (int i = 0; i < header->e_phnum; i++) {
+		if (program_headers[i].p_type == PT_LOAD) {
+			count += count_tables(program_headers[i].p_vaddr, program_headers[i].p_memsz, ARC_ELF_RELOCATE);
+		}
+	}
+
+	return count;
+}
+
+int elf_segment(void *file, int index, uint64_t *vaddr, uint64_t *size, int *writable) {
+	struct Elf64_Ehdr *header = (struct Elf64_Ehdr *)file;
+
+	if (!is_elf(header) || index >= header->e_phnum) {
+		return -1;
+	}
+
+	struct Elf64_Phdr *segment = (struct Elf64_Phdr *)(file + header->e_phoff) + index;
+
+	if (segment->p_type != PT_LOAD || segment->p_memsz == 0) {
+		return 1;
+	}
+
+	*vaddr = segment->p_vaddr;
+	*size = segment->p_memsz;
+	*writable = (segment->p_flags & PF_W) != 0;
+
+	return 0;
+}
+
+int elf_tls(void *file, struct ARC_KernelTLS *tls) {
+	struct Elf64_Ehdr *header = (struct Elf64_Ehdr *)file;
+
+	if (!is_elf(header)) {
+		return -1;
+	}
+
+	struct Elf64_Phdr *program_headers = (struct Elf64_Phdr *)(file + header->e_phoff);
+
+	for (int i = 0; i < header->e_phnum; i++) {
+		if (program_headers[i].p_type != PT_TLS || program_headers[i].p_memsz == 0) {
+			continue;
+		}
+
+		tls->offset = program_headers[i].p_offset;
+		tls->file_size = program_headers[i].p_filesz;
+		tls->mem_size = program_headers[i].p_memsz;
+		tls->align = max(program_headers[i].p_align, 1);
+
+		return 0;
+	}
+
+	return -1;
+}
+
+int read_elf_notes(void *file) {
+	struct Elf64_Ehdr *header = (struct Elf64_Ehdr *)file;
+
+	kernel_notes = (struct ARC_KernelNotes){ 0 };
+
+	if (!is_elf(header)) {
+		return -1;
+	}
+
+	struct Elf64_Phdr *program_headers = (struct Elf64_Phdr *)(file + header->e_phoff);
+
+	for (int i = 0; i < header->e_phnum; i++) {
+		if (program_headers[i].p_type != PT_NOTE) {
+			continue;
+		}
+
+		void *note = file + program_headers[i].p_offset;
+		void *end = note + program_headers[i].p_filesz;
+
+		while (note + sizeof(struct Elf64_Nhdr) <= end) {
+			struct Elf64_Nhdr *nhdr = (struct Elf64_Nhdr *)note;
+			char *name = (char *)(note + sizeof(struct Elf64_Nhdr));
+			uint64_t *desc = (uint64_t *)((void *)name + ALIGN(nhdr->n_namesz, 4));
+
+			note = (void *)desc + ALIGN(nhdr->n_descsz, 4);
+
+			if (nhdr->n_namesz != sizeof(ARC_NOTE_OWNER) || !names_equal(name, ARC_NOTE_OWNER)) {
+				// Not one of ours
+				continue;
+			}
+
+			if (nhdr->n_descsz < sizeof(uint64_t) || nhdr->n_type >= 32) {
+				ARC_DEBUG(WARN, "Malformed note of type %d\n", nhdr->n_type);
+				continue;
+			}
+
+			switch (nhdr->n_type) {
+			case ARC_NOTE_HHDM_BASE: {
+				kernel_notes.hhdm_base = *desc;
+				break;
+			}
+
+			case ARC_NOTE_PAGE_SIZES: {
+				kernel_notes.page_sizes = *desc;
+				break;
+			}
+
+			case ARC_NOTE_EARLY_HEAP: {
+				kernel_notes.early_heap_size = *desc;
+				break;
+			}
+
+			case ARC_NOTE_STACK_SIZE: {
+				kernel_notes.stack_size = *desc;
+				break;
+			}
+
+			case ARC_NOTE_FEATURES: {
+				kernel_notes.features = *desc;
+				break;
+			}
+
+			case ARC_NOTE_PAGING_LEVELS: {
+				kernel_notes.paging_levels = *desc;
+				break;
+			}
+
+			default: {
+				ARC_DEBUG(WARN, "Unknown note of type %d\n", nhdr->n_type);
+				continue;
+			}
+			}
+
+			kernel_notes.present |= 1 << nhdr->n_type;
+
+			ARC_DEBUG(INFO, "Kernel note %d: 0x%"PRIx64"\n", nhdr->n_type, *desc);
+		}
+	}
+
+	return 0;
+}
+
+// Recommended multi-byte NOPs, indexed by length
+static const uint8_t nops[][9] = {
+	[1] = { 0x90 },
+	[2] = { 0x66, 0x90 },
+	[3] = { 0x0F, 0x1F, 0x00 },
+	[4] = { 0x0F, 0x1F, 0x40, 0x00 },
+	[5] = { 0x0F, 0x1F, 0x44, 0x00, 0x00 },
+	[6] = { 0x66, 0x0F, 0x1F, 0x44, 0x00, 0x00 },
+	[7] = { 0x0F, 0x1F, 0x80, 0x00, 0x00, 0x00, 0x00 },
+	[8] = { 0x0F, 0x1F, 0x84, 0x00, 0x00, 0x00, 0x00, 0x00 },
+	[9] = { 0x66, 0x0F, 0x1F, 0x84, 0x00, 0x00, 0x00, 0x00, 0x00 },
+};
+
+static struct Elf64_Shdr *find_section(void *file, struct Elf64_Ehdr *header, char *name) {
+	struct Elf64_Shdr *section_headers = ((struct Elf64_Shdr *)(file + header->e_shoff));
+	char *str_table_base = (char *)(file + section_headers[header->e_shstrndx].sh_offset);
+
+	for (int i = 0; i < header->e_shnum; i++) {
+		char *section_name = str_table_base + section_headers[i].sh_name;
+
+		if (names_equal(section_name, name)) {
+			return &section_headers[i];
+		}
+	}
+
+	return NULL;
+}
+
+// Return: physical pointer to the loaded byte at vaddr, NULL if unmapped
+static uint8_t *image_byte(uint64_t *pml4, uint64_t vaddr) {
+	uint64_t paddr = 0;
+
+	if (translate(pml4, vaddr, &paddr) != 0) {
+		return NULL;
+	}
+
+	return (uint8_t *)((uint32_t)paddr);
+}
+
+// Patch every .altinstructions site whose feature is present
+// Return: number of sites patched
+static int patch_alternatives(uint64_t *pml4, void *file, struct Elf64_Ehdr *header) {
+	struct Elf64_Shdr *section = find_section(file, header, ".altinstructions");
+
+	if (section == NULL) {
+		return 0;
+	}
+
+	struct ARC_AltInstr *alts = (struct ARC_AltInstr *)(file + section->sh_offset);
+	int count = section->sh_size / sizeof(struct ARC_AltInstr);
+	int patched = 0;
+
+	// Later entries for the same site win, so list the best variant last
+	for (int i = 0; i < count; i++) {
+		struct ARC_AltInstr *alt = &alts[i];
+		uint8_t code[ARC_ALT_MAX_LEN];
+
+		if ((alt->feature & cpu_features) != alt->feature) {
+			continue;
+		}
+
+		if (alt->site_len > ARC_ALT_MAX_LEN || alt->replacement_len > alt->site_len) {
+			ARC_DEBUG(WARN, "Alternative %d does not fit its site\n", i);
+			continue;
+		}
+
+		int len = 0;
+		for (; len < alt->replacement_len; len++) {
+			uint8_t *byte = image_byte(pml4, alt->replacement + len);
+
+			if (byte == NULL) {
+				break;
+			}
+
+			code[len] = *byte;
+		}
+
+		if (len != alt->replacement_len) {
+			ARC_DEBUG(WARN, "Replacement for 0x%"PRIx64" is not loaded\n", alt->site);
+			continue;
+		}
+
+		// Pad the rest of the site
+		while (len < alt->site_len) {
+			int nop_len = min(alt->site_len - len, 9);
+
+			for (int j = 0; j < nop_len; j++) {
+				code[len + j] = nops[nop_len][j];
+			}
+
+			len += nop_len;
+		}
+
+		// Check the whole site first, so it is never left half patched
+		int mapped = 0;
+		while (mapped < len && image_byte(pml4, alt->site + mapped) != NULL) {
+			mapped++;
+		}
+
+		if (mapped != len) {
+			ARC_DEBUG(WARN, "Site 0x%"PRIx64" is not loaded\n", alt->site);
+			continue;
+		}
+
+		for (int j = 0; j < len; j++) {
+			*image_byte(pml4, alt->site + j) = code[j];
+		}
+
+		patched++;
+	}
+
+	ARC_DEBUG(INFO, "Patched %d of %d alternatives\n", patched, count);
+
+	return patched;
+}
+
+uint32_t elf_header_hash(void *file) {
+	struct Elf64_Ehdr *header = (struct Elf64_Ehdr *)file;
+	uint8_t *data = (uint8_t *)file;
+	uint32_t hash = 0x811C9DC5;
+
+	for (uint32_t i = 0; i < sizeof(struct Elf64_Ehdr); i++) {
+		hash = (hash ^ data[i]) * 0x01000193;
+	}
+
+	data = (uint8_t *)(file + header->e_phoff);
+
+	for (uint32_t i = 0; i < (uint32_t)header->e_phnum * header->e_phentsize; i++) {
+		hash = (hash ^ data[i]) * 0x01000193;
+	}
+
+	return hash;
+}
+
+int finish_elf(uint64_t *pml4, void *file) {
+	struct Elf64_Ehdr *header = (struct Elf64_Ehdr *)file;
+
+	if (!is_elf(header)) {
+		return -1;
+	}
+
+	if (load_symbols(file, header) != 0) {
+		ARC_DEBUG(WARN, "Kernel symbols are unavailable\n");
+	}
+
+	_boot_meta.alt_patched = patch_alternatives(pml4, file, header);
+
+	return 0;
+}
 
 // TODO: Support PIE objects
 // Return e_entry: success
@@ -136,8 +608,7 @@ uint64_t load_elf(uint64_t *pml4, void *file) {
 	uint64_t *old_pml4 = pml4;
 	struct Elf64_Ehdr *header = (struct Elf64_Ehdr *)file;
 
-	if (header->e_ident[0] != 0x7F || header->e_ident[1] != 'E' ||
-	    header->e_ident[2] != 'L' || header->e_ident[3] != 'F') {
+	if (!is_elf(header)) {
 		// Memory is not of type ELF, error
 		ARC_DEBUG(ERR, "Memory region provided is not an ELF file\n");
 		return 0;
@@ -148,6 +619,22 @@ uint64_t load_elf(uint64_t *pml4, void *file) {
 
 	ARC_DEBUG(INFO, "Entry at: 0x%"PRIx64"\n", header->e_entry);
 
+	if (load_symbols(file, header) != 0) {
+		ARC_DEBUG(WARN, "Kernel symbols are unavailable\n");
+	}
+
+	if (ARC_ELF_RELOCATE) {
+		int err = relocate_segments(pml4, file, header);
+
+		if (err == 0) {
+			_boot_meta.alt_patched = patch_alternatives(pml4, file, header);
+		}
+
+		ARC_DEBUG(INFO, "-----------\n")
+
+		return err == 0 ? header->e_entry : 1;
+	}
+
 	struct Elf64_Shdr *section_headers = ((struct Elf64_Shdr *)(file + header->e_shoff));
 	char *str_table_base = (char *)(file + section_headers[header->e_shstrndx].sh_offset);
 
@@ -175,6 +662,23 @@ uint64_t load_elf(uint64_t *pml4, void *file) {
 			continue;
 		}
 
+		if (section.sh_type == SHT_NOBITS && (section.sh_flags & SHF_TLS) != 0) {
+			// .tbss only describes the TLS template, it occupies
+			// no memory of its own at sh_addr
+			continue;
+		}
+
+		if (section.sh_type == SHT_NOBITS) {
+			// Section is not present in file, allocate
+			// memory for it
+			if (load_nobits(pml4, vaddr, section.sh_size) != 0) {
+				ARC_DEBUG(ERR, "\tFailed to load NOBITS section\n");
+				return 1;
+			}
+
+			continue;
+		}
+
 		// Page count == 0, but it is a section we need?
 		// Re-calculate without the check if the size < 0
 		highest_address = ALIGN(section.sh_size, 0x1000) / 0x1000;
@@ -185,16 +689,7 @@ uint64_t load_elf(uint64_t *pml4, void *file) {
 		for (int j = 0; j < highest_address; j++) {
 			uint32_t paddr = paddr_file + (j << 12);
 
-			if (section.sh_type == SHT_NOBITS) {
-				// Section is not present in file, allocate
-				// memory for it
-				paddr = (uintptr_t)Arc_ListAlloc(&physical_mem);
-				memset((void *)paddr, 0, 0x1000);
-
-				ARC_DEBUG(INFO, "\tSection is of type NOBITS, allocated 0x%"PRIx64" for it\n", paddr);
-			}
-
-			pml4 = map_page(pml4, vaddr + (j << 12), paddr, 0);
+			pml4 = map_page(pml4, vaddr + (j << 12), paddr, ARC_VMM_WRITE, 0);
 
 			if (pml4 == NULL || (pml4 != old_pml4 && old_pml4 != NULL)) {
 				ARC_DEBUG(INFO, "\tOverlapping section, ignoring\n");
@@ -203,6 +698,8 @@ uint64_t load_elf(uint64_t *pml4, void *file) {
 		}
 	}
 
+	_boot_meta.alt_patched = patch_alternatives(pml4, file, header);
+
 	ARC_DEBUG(INFO, "-----------\n")
 
 	return header->e_entry;
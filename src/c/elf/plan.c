@@ -0,0 +1,234 @@
+/**
+ * @file plan.c
+ *
+ * @author awewsomegamer <awewsomegamer@gmail.com>
+ *
+ * @LICENSE
+ * Arctan-MB2BSP - Multiboot2 Bootstrapper for Arctan Kernel
+ * Copyright (C) 2023-2024 awewsomegamer
+ *
+ * This file is part of Arctan-MB2BSP
+ *
+ * Arctan is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; version 2
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * @DESCRIPTION
+ * Loading the kernel from a boot plan made by tools/bootplan.
+*/
+#include <elf/plan.h>
+#include <elf/elf.h>
+#include <mm/ptarena.h>
+#include <mm/freelist.h>
+#include <mm/vmm.h>
+#include <global.h>
+#include <util.h>
+
+#define ADDRESS_MASK 0x000FFFFFFFFFF000ULL
+
+// Check that count elements of the given size at offset lie within size bytes
+static int in_bounds(uint64_t offset, uint64_t count, uint64_t elem, uint64_t size) {
+	return offset <= size && count * elem <= size - offset;
+}
+
+// Return 0: every present entry of the plan's tables refers to
+// something in the plan
+static int check_tables(struct ARC_PlanHeader *plan) {
+	uint64_t *tables = (uint64_t *)((void *)plan + (uint32_t)plan->tables_offset);
+
+	for (uint32_t i = 0; i < plan->table_count * 512; i++) {
+		uint64_t entry = tables[i];
+
+		if ((entry & 1) == 0) {
+			continue;
+		}
+
+		uint64_t index = (entry & ADDRESS_MASK) >> 12;
+		int large = (entry >> 7) & 1;
+
+		if ((entry & ARC_PLAN_REF_TABLE) && !(entry & ARC_PLAN_REF_FRAME) && !large) {
+			if (index >= plan->table_count) {
+				return -1;
+			}
+		} else if ((entry & ARC_PLAN_REF_FRAME) && !(entry & ARC_PLAN_REF_TABLE)) {
+			if (index + (large ? 512 : 1) > plan->frame_count) {
+				return -1;
+			}
+
+			if (large && (index + plan->phase) % 512 != 0) {
+				return -1;
+			}
+		} else {
+			return -1;
+		}
+	}
+
+	return 0;
+}
+
+// Return the plan in _boot_meta.boot_plan if it can be used for the kernel
+// Return NULL: no usable plan
+static struct ARC_PlanHeader *usable_plan() {
+	if (_boot_meta.boot_plan == 0 || _boot_meta.kernel_elf == 0) {
+		return NULL;
+	}
+
+	struct ARC_PlanHeader *plan = (struct ARC_PlanHeader *)((uint32_t)_boot_meta.boot_plan);
+	uint32_t size = _boot_meta.boot_plan_size;
+
+	if (size < sizeof(struct ARC_PlanHeader) || plan->magic != ARC_PLAN_MAGIC || plan->version != ARC_PLAN_VERSION) {
+		ARC_DEBUG(ERR, "Unsupported boot plan\n");
+		return NULL;
+	}
+
+	if (plan->kernel_hash != elf_header_hash((void *)((uint32_t)_boot_meta.kernel_elf))) {
+		ARC_DEBUG(WARN, "Boot plan was made for another kernel\n");
+		return NULL;
+	}
+
+	if (plan->levels != (uint32_t)vmm_levels || (plan->large_pages && !vmm_large_pages)) {
+		ARC_DEBUG(WARN, "Boot plan was made for another paging mode (%d levels, large pages: %d)\n", plan->levels, plan->large_pages);
+		return NULL;
+	}
+
+	if (plan->phase >= 512 || plan->table_count == 0
+	    || !in_bounds(plan->tables_offset, plan->table_count, 0x1000, size)
+	    || !in_bounds(plan->roots_offset, plan->root_count, sizeof(struct ARC_PlanRoot), size)
+	    || !in_bounds(plan->copies_offset, plan->copy_count, sizeof(struct ARC_PlanCopy), size)
+	    || !in_bounds(plan->zeros_offset, plan->zero_count, sizeof(struct ARC_PlanZero), size)) {
+		ARC_DEBUG(ERR, "Boot plan is truncated\n");
+		return NULL;
+	}
+
+	uint64_t image_size = (uint64_t)plan->frame_count * 0x1000;
+	struct ARC_PlanRoot *roots = (struct ARC_PlanRoot *)((void *)plan + (uint32_t)plan->roots_offset);
+	struct ARC_PlanCopy *copies = (struct ARC_PlanCopy *)((void *)plan + (uint32_t)plan->copies_offset);
+	struct ARC_PlanZero *zeros = (struct ARC_PlanZero *)((void *)plan + (uint32_t)plan->zeros_offset);
+
+	for (uint32_t i = 0; i < plan->root_count; i++) {
+		uint64_t index = (roots[i].entry & ADDRESS_MASK) >> 12;
+
+		if (roots[i].slot >= 512 || !(roots[i].entry & ARC_PLAN_REF_TABLE) || index >= plan->table_count) {
+			ARC_DEBUG(ERR, "Boot plan root %d is invalid\n", i);
+			return NULL;
+		}
+	}
+
+	for (uint32_t i = 0; i < plan->copy_count; i++) {
+		if (!in_bounds(copies[i].offset, copies[i].size, 1, image_size)
+		    || !in_bounds(copies[i].file_offset, copies[i].size, 1, _boot_meta.kernel_elf_size)) {
+			ARC_DEBUG(ERR, "Boot plan copy %d is out of bounds\n", i);
+			return NULL;
+		}
+	}
+
+	for (uint32_t i = 0; i < plan->zero_count; i++) {
+		if (!in_bounds(zeros[i].offset, zeros[i].size, 1, image_size)) {
+			ARC_DEBUG(ERR, "Boot plan zero %d is out of bounds\n", i);
+			return NULL;
+		}
+	}
+
+	if (check_tables(plan) != 0) {
+		ARC_DEBUG(ERR, "Boot plan tables are invalid\n");
+		return NULL;
+	}
+
+	return plan;
+}
+
+int plan_count_tables() {
+	struct ARC_PlanHeader *plan = usable_plan();
+
+	return plan == NULL ? 0 : plan->table_count;
+}
+
+uint64_t load_plan(uint64_t *pml4, void *file) {
+	struct ARC_PlanHeader *plan = usable_plan();
+
+	if (plan == NULL || pml4 == NULL) {
+		return 0;
+	}
+
+	struct ARC_PlanRoot *roots = (struct ARC_PlanRoot *)((void *)plan + (uint32_t)plan->roots_offset);
+
+	for (uint32_t i = 0; i < plan->root_count; i++) {
+		if ((pml4[roots[i].slot] & 1) == 1) {
+			ARC_DEBUG(WARN, "Boot plan root slot %d is in use\n", roots[i].slot);
+			return 0;
+		}
+	}
+
+	uint8_t *extent = (uint8_t *)Arc_ListContiguousAlignedAlloc(&physical_mem, plan->phase + plan->frame_count, 0x200000);
+
+	if (extent == NULL) {
+		ARC_DEBUG(ERR, "Failed to allocate 0x%x pages for the kernel image\n", plan->frame_count);
+		return 0;
+	}
+
+	uint64_t *tables = (uint64_t *)alloc_tables(plan->table_count);
+
+	if (tables == NULL) {
+		ARC_DEBUG(ERR, "Failed to allocate %d page tables\n", plan->table_count);
+		Arc_ListContiguousFree(&physical_mem, extent, plan->phase + plan->frame_count);
+		return 0;
+	}
+
+	if (plan->phase > 0) {
+		Arc_ListContiguousFree(&physical_mem, extent, plan->phase);
+	}
+
+	uint8_t *image = extent + plan->phase * 0x1000;
+
+	ARC_DEBUG(INFO, "Loading kernel from boot plan: %d tables at 0x%"PRIxPTR", %d pages at 0x%"PRIxPTR"\n", plan->table_count, (uintptr_t)tables, plan->frame_count, (uintptr_t)image);
+
+	// Relocate the tables
+	fast_memcpy(tables, (void *)plan + (uint32_t)plan->tables_offset, plan->table_count * 0x1000);
+
+	for (uint32_t i = 0; i < plan->table_count * 512; i++) {
+		uint64_t entry = tables[i];
+
+		if ((entry & 1) == 0) {
+			continue;
+		}
+
+		uint32_t index = (entry & ADDRESS_MASK) >> 12;
+		uint32_t base = (entry & ARC_PLAN_REF_TABLE) ? (uintptr_t)tables : (uintptr_t)image;
+
+		entry &= ~(ADDRESS_MASK | ARC_PLAN_REF_TABLE | ARC_PLAN_REF_FRAME);
+		tables[i] = entry | (base + index * 0x1000);
+	}
+
+	// Fill in the image
+	struct ARC_PlanZero *zeros = (struct ARC_PlanZero *)((void *)plan + (uint32_t)plan->zeros_offset);
+	struct ARC_PlanCopy *copies = (struct ARC_PlanCopy *)((void *)plan + (uint32_t)plan->copies_offset);
+
+	for (uint32_t i = 0; i < plan->zero_count; i++) {
+		fast_memset(image + (uint32_t)zeros[i].offset, 0, (uint32_t)zeros[i].size);
+	}
+
+	for (uint32_t i = 0; i < plan->copy_count; i++) {
+		fast_memcpy(image + (uint32_t)copies[i].offset, file + (uint32_t)copies[i].file_offset, (uint32_t)copies[i].size);
+	}
+
+	// Link the kernel into the address space
+	for (uint32_t i = 0; i < plan->root_count; i++) {
+		uint32_t index = (roots[i].entry & ADDRESS_MASK) >> 12;
+		uint64_t entry = roots[i].entry & ~(ADDRESS_MASK | ARC_PLAN_REF_TABLE | ARC_PLAN_REF_FRAME);
+
+		pml4[roots[i].slot] = entry | ((uintptr_t)tables + index * 0x1000);
+	}
+
+	_boot_meta.boot_plan_used = 1;
+
+	return plan->entry;
+}
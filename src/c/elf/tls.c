@@ -0,0 +1,126 @@
+/**
+ * @file tls.c
+ *
+ * @author awewsomegamer <awewsomegamer@gmail.com>
+ *
+ * @LICENSE
+ * Arctan-MB2BSP - Multiboot2 Bootstrapper for Arctan Kernel
+ * Copyright (C) 2023-2024 awewsomegamer
+ *
+ * This file is part of Arctan-MB2BSP
+ *
+ * Arctan is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; version 2
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * @DESCRIPTION
+ * Per-CPU TLS blocks made from the kernel's PT_TLS segment.
+*/
+#include <elf/tls.h>
+#include <elf/elf.h>
+#include <mm/freelist.h>
+#include <mm/vmm.h>
+#include <global.h>
+#include <util.h>
+
+/// Smallest alignment of a TLS block, a cache line.
+#define BLOCK_ALIGN 64
+
+// Lay out the blocks for the given template
+// Return: bytes from the start of a block to its thread pointer, 0 if
+// the template cannot be used
+static uint64_t tls_layout(struct ARC_KernelTLS *tls, uint64_t *stride) {
+	if ((tls->align & (tls->align - 1)) != 0 || tls->file_size > tls->mem_size) {
+		ARC_DEBUG(ERR, "Bad PT_TLS segment (alignment 0x%"PRIx64")\n", tls->align);
+		return 0;
+	}
+
+	uint64_t align = max(tls->align, BLOCK_ALIGN);
+	uint64_t offset = ALIGN(tls->mem_size, tls->align);
+
+	*stride = ALIGN(offset + ARC_TLS_TCB_SIZE, align);
+
+	return offset;
+}
+
+int tls_count_tables() {
+	struct ARC_KernelTLS tls = { 0 };
+	uint64_t stride = 0;
+
+	if (_boot_meta.kernel_elf == 0 || elf_tls((void *)((uint32_t)_boot_meta.kernel_elf), &tls) != 0
+	    || tls_layout(&tls, &stride) == 0) {
+		return 0;
+	}
+
+	int cpus = max(_boot_meta.cpu_count, 1);
+
+	return count_tables(ARC_TLS_VADDR, ALIGN(cpus * stride, 0x1000), 0);
+}
+
+int create_tls_blocks(void *file) {
+	struct ARC_KernelTLS tls = { 0 };
+	uint64_t stride = 0;
+
+	if (elf_tls(file, &tls) != 0) {
+		return 0;
+	}
+
+	uint64_t offset = tls_layout(&tls, &stride);
+
+	if (offset == 0) {
+		return -1;
+	}
+
+	int cpus = max(_boot_meta.cpu_count, 1);
+	int pages = ALIGN(cpus * stride, 0x1000) / 0x1000;
+	uint8_t *region = (uint8_t *)Arc_ListContiguousAlignedAlloc(&physical_mem, pages, max(tls.align, 0x1000));
+
+	if (region == NULL) {
+		ARC_DEBUG(ERR, "Failed to allocate %d pages for TLS blocks\n", pages);
+		return -1;
+	}
+
+	// .tbss, the padding and the TCBs all start out zeroed
+	fast_memset(region, 0, pages * 0x1000);
+
+	for (int i = 0; i < cpus; i++) {
+		uint8_t *block = region + i * stride;
+		uint64_t pointer = ARC_TLS_VADDR + i * stride + offset;
+
+		fast_memcpy(block, file + tls.offset, tls.file_size);
+		*(uint64_t *)(block + offset) = pointer;
+	}
+
+	pml4 = map_range(pml4, ARC_TLS_VADDR, (uintptr_t)region, pages * 0x1000, ARC_VMM_WRITE | ARC_VMM_WB, 0);
+
+	if (pml4 == NULL) {
+		ARC_DEBUG(ERR, "Failed to map TLS blocks\n");
+		ARC_HANG
+	}
+
+	_boot_meta.tls = ARC_TLS_VADDR;
+	_boot_meta.tls_paddr = (uintptr_t)region;
+	_boot_meta.tls_stride = stride;
+	_boot_meta.tls_offset = offset;
+
+	ARC_DEBUG(INFO, "Created %d TLS blocks of 0x%"PRIx64" B (0x%"PRIx64" B of .tdata) at 0x%"PRIxPTR"\n", cpus, stride, tls.file_size, (uintptr_t)region);
+
+	return 0;
+}
+
+uint64_t tls_pointer(int cpu) {
+	if (_boot_meta.tls == 0) {
+		return 0;
+	}
+
+	return _boot_meta.tls + (uint64_t)cpu * _boot_meta.tls_stride + _boot_meta.tls_offset;
+}
@@ -0,0 +1,44 @@
+/**
+ * @file acpi.h
+ *
+ * @author awewsomegamer <awewsomegamer@gmail.com>
+ *
+ * @LICENSE
+ * Arctan-MB2BSP - Multiboot2 Bootstrapper for Arctan Kernel
+ * Copyright (C) 2023-2024 awewsomegamer
+ *
+ * This file is part of Arctan-MB2BSP
+ *
+ * Arctan is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; version 2
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * @DESCRIPTION
+ * Minimal ACPI table reader, used to discover what the bootstrapper needs
+ * to know about the system before the kernel is loaded.
+*/
+#ifndef ARC_ACPI_ACPI_H
+#define ARC_ACPI_ACPI_H
+
+/**
+ * Read the ACPI tables pointed to by _boot_meta.rsdp.
+ *
+ * The MMIO windows of the LAPIC, IOAPICs, HPET and PCIe ECAM
+ * are registered with the HHDM, so this must be called before
+ * create_hhdm. The CPUs listed in the MADT are counted into
+ * _boot_meta.cpu_count and recorded with apic_add_cpu.
+ *
+ * @return Error code (0: success).
+ * */
+int read_acpi();
+
+#endif
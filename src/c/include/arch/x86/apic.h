@@ -0,0 +1,82 @@
+/**
+ * @file apic.h
+ *
+ * @author awewsomegamer <awewsomegamer@gmail.com>
+ *
+ * @LICENSE
+ * Arctan-MB2BSP - Multiboot2 Bootstrapper for Arctan Kernel
+ * Copyright (C) 2023-2024 awewsomegamer
+ *
+ * This file is part of Arctan-MB2BSP
+ *
+ * Arctan is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; version 2
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * @DESCRIPTION
+ * Local APIC mode and the APIC ID to CPU index map.
+*/
+#ifndef ARC_ARCH_X86_APIC_H
+#define ARC_ARCH_X86_APIC_H
+
+#include <global.h>
+
+#ifndef ARC_X2APIC
+/// Switch the local APIC to x2APIC mode if the CPU has it (0: leave it as is).
+#define ARC_X2APIC 1
+#endif
+
+/// Most CPUs recorded by apic_add_cpu.
+#define ARC_APIC_MAX_CPUS 1024
+/// Highest APIC ID apic_map can be made for, plus one.
+#define ARC_APIC_MAP_MAX 0x10000
+
+/**
+ * Set up the BSP's local APIC.
+ *
+ * Switches the local APIC to x2APIC mode if the CPU has it and
+ * ARC_X2APIC is set, then records the mode and the BSP's APIC ID
+ * in _boot_meta. APs must be switched by whoever starts them.
+ *
+ * @return Error code (0: success).
+ * */
+int init_apic();
+
+/**
+ * Record a CPU listed in the MADT.
+ *
+ * CPUs get indices in the order they are recorded.
+ *
+ * @param uint32_t apic_id - APIC or x2APIC ID of the CPU.
+ * @return 0 if the CPU was recorded, -1 if it already was or
+ * there are too many CPUs.
+ * */
+int apic_add_cpu(uint32_t apic_id);
+
+/**
+ * Get the APIC ID of a CPU.
+ *
+ * @param int cpu - Index of the CPU.
+ * @return The APIC ID recorded for it, the BSP's if there is none.
+ * */
+uint32_t apic_cpu_id(int cpu);
+
+/**
+ * Create the APIC ID to CPU index map in _boot_meta.apic_map.
+ *
+ * Must be called after read_acpi and create_hhdm.
+ *
+ * @return Error code (0: success).
+ * */
+int create_apic_map();
+
+#endif
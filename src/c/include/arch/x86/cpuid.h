@@ -28,6 +28,32 @@
 #ifndef ARC_ARCH_X86_CPUID_H
 #define ARC_ARCH_X86_CPUID_H
 
+#include <stdint.h>
+#include <arctan.h>
+
+// Bits match the ARC_NOTE_FEATURE_* bits kernels can require
+/// Page Attribute Table.
+#define ARC_CPU_FEATURE_PAT  ARC_NOTE_FEATURE_PAT
+/// Enhanced REP MOVSB / STOSB.
+#define ARC_CPU_FEATURE_ERMS ARC_NOTE_FEATURE_ERMS
+/// SSE2 (non-temporal stores).
+#define ARC_CPU_FEATURE_SSE2 ARC_NOTE_FEATURE_SSE2
+/// AVX2.
+#define ARC_CPU_FEATURE_AVX2 ARC_NOTE_FEATURE_AVX2
+/// POPCNT.
+#define ARC_CPU_FEATURE_POPCNT ARC_NOTE_FEATURE_POPCNT
+/// CLFLUSHOPT.
+#define ARC_CPU_FEATURE_CLFLUSHOPT ARC_NOTE_FEATURE_CLFLUSHOPT
+/// Five-level paging.
+#define ARC_CPU_FEATURE_LA57 ARC_NOTE_FEATURE_LA57
+/// x2APIC.
+#define ARC_CPU_FEATURE_X2APIC ARC_NOTE_FEATURE_X2APIC
+/// SSE4.2.
+#define ARC_CPU_FEATURE_SSE42 ARC_NOTE_FEATURE_SSE42
+
+/// Features detected by check_features (ARC_CPU_FEATURE_*).
+extern uint32_t cpu_features;
+
 /**
  * Check for CPU features.
  *
@@ -0,0 +1,49 @@
+/**
+ * @file crc32c.h
+ *
+ * @author awewsomegamer <awewsomegamer@gmail.com>
+ *
+ * @LICENSE
+ * Arctan-MB2BSP - Multiboot2 Bootstrapper for Arctan Kernel
+ * Copyright (C) 2023-2024 awewsomegamer
+ *
+ * This file is part of Arctan-MB2BSP
+ *
+ * Arctan is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; version 2
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * @DESCRIPTION
+ * CRC32C with the SSE4.2 crc32 instruction.
+*/
+#ifndef ARC_ARCH_X86_CRC32C_H
+#define ARC_ARCH_X86_CRC32C_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * Extern assembly function to update a CRC32C register.
+ *
+ * Requires SSE4.2. No inversion is done on crc.
+ * */
+extern uint32_t _x86_crc32c(uint32_t crc, void *data, size_t size);
+
+/**
+ * Extern assembly function to update three CRC32C registers at once.
+ *
+ * Requires SSE4.2. crc[i] is updated with the len bytes at
+ * data + i * len, len must be a non-zero multiple of 4.
+ * */
+extern void _x86_crc32c_3way(uint32_t *crc, void *data, size_t len);
+
+#endif
@@ -28,6 +28,8 @@
 #ifndef ARC_ARCH_X86_GDT_H
 #define ARC_ARCH_X86_GDT_H
 
+#include <stdint.h>
+
 /**
  * Create a GDT.
  *
@@ -35,7 +37,19 @@
  * [1]: 32 Kernel Code.
  * [2]: 32/64 Kernel Data.
  * [3]: 64 Kernel Code.
+ * [4]: 64-bit TSS (two entries, see init_idt64).
  * */
 void install_gdt();
 
+/**
+ * Set a GDT entry.
+ *
+ * @param int i - Index of the entry.
+ * @param uint32_t base - Base of the segment.
+ * @param uint32_t limit - 20-bit limit of the segment.
+ * @param uint8_t access - Access byte.
+ * @param uint8_t flags - 4-bit flags.
+ * */
+void set_gdt_gate(int i, uint32_t base, uint32_t limit, uint8_t access, uint8_t flags);
+
 #endif
@@ -0,0 +1,64 @@
+/**
+ * @file idt64.h
+ *
+ * @author awewsomegamer <awewsomegamer@gmail.com>
+ *
+ * @LICENSE
+ * Arctan-MB2BSP - Multiboot2 Bootstrapper for Arctan Kernel
+ * Copyright (C) 2023-2024 awewsomegamer
+ *
+ * This file is part of Arctan-MB2BSP
+ *
+ * Arctan is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; version 2
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * @DESCRIPTION
+ * 64-bit IDT catching exceptions between entering long mode and the
+ * kernel installing its own IDT.
+*/
+#ifndef ARC_ARCH_X86_IDT64_H
+#define ARC_ARCH_X86_IDT64_H
+
+#include <global.h>
+
+#ifndef ARC_IDT64_STACK_SIZE
+/// Size in bytes of the stack exceptions are handled on.
+#define ARC_IDT64_STACK_SIZE 0x1000
+#endif
+
+/// GDT selector of the TSS holding the exception stack.
+#define ARC_IDT64_TSS_SELECTOR 0x20
+
+/// Where exceptions taken before the kernel's IDT are recorded (see
+/// _boot_meta.crash_record), a record of its own if NULL when init_idt64 is called.
+extern struct ARC_CrashRecord *crash_record;
+
+/**
+ * Prepare the 64-bit IDT.
+ *
+ * Builds a 64-bit IDT for the 32 exception vectors and a TSS whose
+ * IST1 stack every one of them runs on, so that even a fault on a bad
+ * kernel stack is caught. _kernel_station loads both right before
+ * entering the kernel.
+ *
+ * Each exception is recorded in crash_record and written to port
+ * 0xE9 if ARC_E9HACK_ENABLE is defined. #DB and #BP return, anything
+ * else halts the CPU.
+ *
+ * Must be called after install_gdt, on every boot, as loading the
+ * TSS marks it busy. If boot_record is set, its checksum is kept
+ * valid when an exception is recorded.
+ * */
+void init_idt64();
+
+#endif
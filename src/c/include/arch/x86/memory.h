@@ -0,0 +1,68 @@
+/**
+ * @file memory.h
+ *
+ * @author awewsomegamer <awewsomegamer@gmail.com>
+ *
+ * @LICENSE
+ * Arctan-MB2BSP - Multiboot2 Bootstrapper for Arctan Kernel
+ * Copyright (C) 2023-2024 awewsomegamer
+ *
+ * This file is part of Arctan-MB2BSP
+ *
+ * Arctan is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; version 2
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * @DESCRIPTION
+ * C headers for assembly memory copy and fill functions.
+*/
+#ifndef ARC_ARCH_X86_MEMORY_H
+#define ARC_ARCH_X86_MEMORY_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * Extern assembly function to copy memory with rep movsb.
+ *
+ * Fastest when the CPU supports ERMS.
+ * */
+extern void _x86_memcpy_movsb(void *a, void *b, size_t size);
+
+/**
+ * Extern assembly function to copy memory with rep movsd.
+ * */
+extern void _x86_memcpy_movsd(void *a, void *b, size_t size);
+
+/**
+ * Extern assembly function to fill memory with rep stosb.
+ *
+ * Fastest when the CPU supports ERMS.
+ * */
+extern void _x86_memset_stosb(void *mem, uint32_t pattern, size_t size);
+
+/**
+ * Extern assembly function to fill memory with rep stosd.
+ *
+ * The fill byte must be repeated in all four bytes of pattern.
+ * */
+extern void _x86_memset_stosd(void *mem, uint32_t pattern, size_t size);
+
+/**
+ * Extern assembly function to fill memory with non-temporal stores.
+ *
+ * Requires SSE2, mem must be 4 byte aligned and size is rounded
+ * down to a multiple of 32 bytes.
+ * */
+extern void _x86_memset_movnti(void *mem, uint32_t pattern, size_t size);
+
+#endif
@@ -0,0 +1,61 @@
+/**
+ * @file msr.h
+ *
+ * @author awewsomegamer <awewsomegamer@gmail.com>
+ *
+ * @LICENSE
+ * Arctan-MB2BSP - Multiboot2 Bootstrapper for Arctan Kernel
+ * Copyright (C) 2023-2024 awewsomegamer
+ *
+ * This file is part of Arctan-MB2BSP
+ *
+ * Arctan is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; version 2
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * @DESCRIPTION
+ * C headers for reading and writing MSRs.
+*/
+#ifndef ARC_ARCH_X86_MSR_H
+#define ARC_ARCH_X86_MSR_H
+
+#include <stdint.h>
+
+#define ARC_MSR_APIC_BASE 0x1B
+#define ARC_MSR_PAT       0x277
+#define ARC_MSR_X2APIC_ID 0x802
+#define ARC_MSR_EFER      0xC0000080
+
+/**
+ * Extern assembly function to read an MSR.
+ *
+ * @param uint32_t msr - The MSR to read.
+ * @return The value of the MSR.
+ * */
+extern uint64_t _x86_rdmsr(uint32_t msr);
+
+/**
+ * Extern assembly function to read the time stamp counter.
+ *
+ * @return The value of the TSC.
+ * */
+extern uint64_t _x86_rdtsc();
+
+/**
+ * Extern assembly function to write an MSR.
+ *
+ * @param uint32_t msr - The MSR to write.
+ * @param uint64_t value - The value to write.
+ * */
+extern void _x86_wrmsr(uint32_t msr, uint64_t value);
+
+#endif
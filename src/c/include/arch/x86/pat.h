@@ -0,0 +1,39 @@
+/**
+ * @file pat.h
+ *
+ * @author awewsomegamer <awewsomegamer@gmail.com>
+ *
+ * @LICENSE
+ * Arctan-MB2BSP - Multiboot2 Bootstrapper for Arctan Kernel
+ * Copyright (C) 2023-2024 awewsomegamer
+ *
+ * This file is part of Arctan-MB2BSP
+ *
+ * Arctan is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; version 2
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * @DESCRIPTION
+ * Called by CPUID to program the PAT.
+*/
+#ifndef ARC_ARCH_X86_PAT_H
+#define ARC_ARCH_X86_PAT_H
+
+/// PA0: WB, PA1: WC, PA2: UC-, PA3: UC, PA4: WB, PA5: WT, PA6: UC-, PA7: UC
+#define ARC_PAT_VALUE 0x0007040600070106ULL
+
+/**
+ * Detect the PAT and program it so that PWT selects WC.
+ * */
+void init_pat(int edx);
+
+#endif
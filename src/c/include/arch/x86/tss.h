@@ -0,0 +1,71 @@
+/**
+ * @file tss.h
+ *
+ * @author awewsomegamer <awewsomegamer@gmail.com>
+ *
+ * @LICENSE
+ * Arctan-MB2BSP - Multiboot2 Bootstrapper for Arctan Kernel
+ * Copyright (C) 2023-2024 awewsomegamer
+ *
+ * This file is part of Arctan-MB2BSP
+ *
+ * Arctan is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; version 2
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * @DESCRIPTION
+ * Per-CPU long mode GDTs, TSSs and stacks for the kernel.
+*/
+#ifndef ARC_ARCH_X86_TSS_H
+#define ARC_ARCH_X86_TSS_H
+
+#include <global.h>
+
+#ifndef ARC_CPU_STACK_SIZE
+/// Size in bytes of each CPU's kernel stack, unless the kernel asks for another.
+#define ARC_CPU_STACK_SIZE 0x10000
+#endif
+
+#ifndef ARC_IST_STACK_SIZE
+/// Size in bytes of each IST stack.
+#define ARC_IST_STACK_SIZE 0x4000
+#endif
+
+/// Virtual base of the per-CPU descriptor tables and stacks.
+#define ARC_CPU_DESC_VADDR 0xFFFFFEA000000000
+
+/**
+ * Estimate the page tables create_cpu_descs will need.
+ *
+ * @return The number of tables (see count_tables).
+ * */
+int cpu_desc_count_tables();
+
+/**
+ * Create the long mode GDT, TSS and stacks of every CPU.
+ *
+ * For each CPU in _boot_meta.cpu_count a 64-bit GDT (see the
+ * ARC_GDT_* selectors) with a TSS descriptor, a TSS with
+ * ARC_CPU_IST_COUNT IST stacks and a kernel stack are carved out of
+ * one physically contiguous region, mapped at ARC_CPU_DESC_VADDR.
+ * Every stack has an unmapped guard page below it, whose frame is
+ * given back to the PMM. The ARC_CPUDesc of each CPU are placed at
+ * the start of the region and handed over in _boot_meta.cpu_desc.
+ *
+ * The kernel stack is as large as the kernel's ARC_NOTE_STACK_SIZE
+ * note asks for, or ARC_CPU_STACK_SIZE.
+ *
+ * @return Error code (0: success).
+ * */
+int create_cpu_descs();
+
+#endif
@@ -29,6 +29,7 @@
 #define ARC_ARCTAN_H
 
 #include <stdint.h>
+#include <stddef.h>
 
 #define ARC_HHDM_VADDR _boot_meta.hhdm_vaddr
 #define ARC_PHYS_TO_HHDM(physical) ((uintptr_t)(physical) + (uintptr_t)ARC_HHDM_VADDR)
@@ -37,6 +38,375 @@
 #define ARC_BOOTPROC_ARCTAN 1
 #define ARC_BOOTPROC_MB2    2
 #define ARC_BOOTPROC_LBP    3
+#define ARC_BOOTPROC_PVH    4
+
+/// The range is not mapped into the HHDM.
+#define ARC_CACHE_NONE 0
+/// The range is mapped write-back.
+#define ARC_CACHE_WB   1
+/// The range is mapped write-combining.
+#define ARC_CACHE_WC   2
+/// The range is mapped uncacheable.
+#define ARC_CACHE_UC   3
+
+/// Owner of the kernel's ELF notes read by the bootstrapper.
+#define ARC_NOTE_OWNER "Arctan"
+/// Desired base of the HHDM (uint64_t).
+#define ARC_NOTE_HHDM_BASE  1
+/// Page sizes the kernel may be mapped with (uint64_t, ARC_NOTE_PAGE_*).
+#define ARC_NOTE_PAGE_SIZES 2
+/// Size of the early kernel heap in bytes (uint64_t).
+#define ARC_NOTE_EARLY_HEAP 3
+/// Size of the kernel stack in bytes (uint64_t).
+#define ARC_NOTE_STACK_SIZE 4
+/// CPU features the kernel cannot run without (uint64_t, ARC_NOTE_FEATURE_*).
+#define ARC_NOTE_FEATURES   5
+/// Paging levels the kernel can run with (uint64_t, 5 to use LA57 if the CPU has it).
+#define ARC_NOTE_PAGING_LEVELS 6
+
+/// 4 KiB pages.
+#define ARC_NOTE_PAGE_4K (1 << 0)
+/// 2 MiB pages.
+#define ARC_NOTE_PAGE_2M (1 << 1)
+
+/// Page Attribute Table.
+#define ARC_NOTE_FEATURE_PAT  (1 << 0)
+/// Enhanced REP MOVSB / STOSB.
+#define ARC_NOTE_FEATURE_ERMS (1 << 1)
+/// SSE2.
+#define ARC_NOTE_FEATURE_SSE2 (1 << 2)
+/// AVX2, the kernel still has to enable AVX state in XCR0.
+#define ARC_NOTE_FEATURE_AVX2 (1 << 3)
+/// POPCNT.
+#define ARC_NOTE_FEATURE_POPCNT (1 << 4)
+/// CLFLUSHOPT.
+#define ARC_NOTE_FEATURE_CLFLUSHOPT (1 << 5)
+/// 57-bit linear addresses (five-level paging).
+#define ARC_NOTE_FEATURE_LA57 (1 << 6)
+/// x2APIC, the local APIC is handed over in x2APIC mode if the CPU has it.
+#define ARC_NOTE_FEATURE_X2APIC (1 << 7)
+/// SSE4.2, used for the crc32 instruction.
+#define ARC_NOTE_FEATURE_SSE42 (1 << 8)
+
+/// Longest site or replacement in an .altinstructions entry.
+#define ARC_ALT_MAX_LEN 64
+
+/// Entry of the kernel's .altinstructions section.
+struct ARC_AltInstr {
+	/// Address of the code to replace (vaddr).
+	uint64_t site;
+	/// Address of the replacement code (vaddr, must be loaded).
+	uint64_t replacement;
+	/// Length of the site in bytes, what the replacement leaves is filled with NOPs.
+	uint16_t site_len;
+	/// Length of the replacement in bytes, at most site_len.
+	uint16_t replacement_len;
+	/// Feature required to use the replacement (ARC_NOTE_FEATURE_*).
+	uint32_t feature;
+}__attribute__((packed));
+
+/// "SNAP"
+#define ARC_SNAPSHOT_MAGIC 0x50414E53
+
+/// The extent's data is copied as is (pages * 0x1000 bytes).
+#define ARC_SNAPSHOT_RAW  0
+/// The extent is zeroed, it has no data.
+#define ARC_SNAPSHOT_ZERO 1
+/// The extent's data is a run-length encoded stream of qwords: a uint32_t
+/// header either followed by (header & 0x7FFFFFFF) literal qwords if bit
+/// 31 is set, or by one qword repeated header times.
+#define ARC_SNAPSHOT_RLE  2
+
+/// Registers restored when resuming from a snapshot.
+struct ARC_SnapshotContext {
+	/// Root page table, must identity map the first 4 MiB and be below 4 GiB.
+	/// EFER.NXE is clear on resume, so the tables must not use the NX bit.
+	uint64_t cr3;
+	/// Only CR4.LA57 is used.
+	uint64_t cr4;
+	/// Should reload the GDT, IDT and anything else not restored here.
+	uint64_t rip;
+	uint64_t rsp;
+	/// RFLAGS.IF is cleared.
+	uint64_t rflags;
+	uint64_t rax;
+	uint64_t rbx;
+	uint64_t rcx;
+	uint64_t rdx;
+	uint64_t rsi;
+	uint64_t rdi;
+	uint64_t rbp;
+	uint64_t r8;
+	uint64_t r9;
+	uint64_t r10;
+	uint64_t r11;
+	uint64_t r12;
+	uint64_t r13;
+	uint64_t r14;
+	uint64_t r15;
+}__attribute__((packed));
+
+/// Start of a snapshot module, followed by extent_count extents.
+struct ARC_SnapshotHeader {
+	uint32_t magic;
+	uint32_t extent_count;
+	struct ARC_SnapshotContext context;
+}__attribute__((packed));
+
+/// Physical pages to restore, followed by size bytes of data padded to 8 bytes.
+struct ARC_SnapshotExtent {
+	/// Page aligned physical address, below 4 GiB.
+	uint64_t paddr;
+	uint32_t pages;
+	/// ARC_SNAPSHOT_*.
+	uint32_t encoding;
+	uint64_t size;
+}__attribute__((packed));
+
+/// "BPLN"
+#define ARC_PLAN_MAGIC   0x4E4C5042
+#define ARC_PLAN_VERSION 1
+
+/// The entry's address is an index into the plan's tables (AVL bit 9).
+#define ARC_PLAN_REF_TABLE (1ULL << 9)
+/// The entry's address is an index into the image frames (AVL bit 10).
+#define ARC_PLAN_REF_FRAME (1ULL << 10)
+
+/// Start of a boot plan module, made by tools/bootplan from a kernel ELF.
+/// Offsets are from the start of the module.
+struct ARC_PlanHeader {
+	uint32_t magic;
+	uint32_t version;
+	/// FNV-1a hash of the kernel's ELF header and program headers.
+	uint32_t kernel_hash;
+	/// Paging levels the tables were built for.
+	uint32_t levels;
+	/// Non-zero if the tables contain 2 MiB pages.
+	uint32_t large_pages;
+	/// Frames the image is offset by from a 2 MiB boundary.
+	uint32_t phase;
+	/// Frames the image is copied into.
+	uint32_t frame_count;
+	uint32_t table_count;
+	uint32_t root_count;
+	uint32_t copy_count;
+	uint32_t zero_count;
+	uint32_t reserved;
+	uint64_t entry;
+	/// table_count page tables, 0x1000 bytes each. Every present entry
+	/// refers to another table or to a frame (ARC_PLAN_REF_*).
+	uint64_t tables_offset;
+	/// root_count ARC_PlanRoot.
+	uint64_t roots_offset;
+	/// copy_count ARC_PlanCopy.
+	uint64_t copies_offset;
+	/// zero_count ARC_PlanZero.
+	uint64_t zeros_offset;
+}__attribute__((packed));
+
+/// Root table entry installed by the plan, the slot must be free.
+struct ARC_PlanRoot {
+	uint32_t slot;
+	uint32_t reserved;
+	/// Entry referring to one of the plan's tables.
+	uint64_t entry;
+}__attribute__((packed));
+
+/// Bytes copied from the kernel file into the image frames.
+struct ARC_PlanCopy {
+	/// Offset into the image frames.
+	uint64_t offset;
+	uint64_t file_offset;
+	uint64_t size;
+}__attribute__((packed));
+
+/// Bytes of the image frames which must be zeroed.
+struct ARC_PlanZero {
+	/// Offset into the image frames.
+	uint64_t offset;
+	uint64_t size;
+}__attribute__((packed));
+
+/// Number of IST stacks in each CPU's TSS (IST1 to IST3).
+#define ARC_CPU_IST_COUNT 3
+
+/// Selectors of the GDTs in ARC_CPUDesc.
+#define ARC_GDT_KERNEL_CODE32 0x08
+#define ARC_GDT_KERNEL_DATA   0x10
+#define ARC_GDT_KERNEL_CODE64 0x18
+/// Base for STAR[63:48], user data is at +8 and 64-bit user code at +16.
+#define ARC_GDT_USER_CODE32   0x20
+#define ARC_GDT_USER_DATA     0x28
+#define ARC_GDT_USER_CODE64   0x30
+#define ARC_GDT_TSS           0x38
+
+/// Long mode descriptor tables and stacks made for one CPU, all
+/// pointers are virtual addresses in the kernel's address space.
+struct ARC_CPUDesc {
+	/// Base of the GDT, for lgdt.
+	uint64_t gdt;
+	/// Limit of the GDT, for lgdt.
+	uint16_t gdt_limit;
+	/// Selector of the TSS, for ltr.
+	uint16_t tss_selector;
+	/// APIC ID of the CPU.
+	uint32_t apic_id;
+	uint64_t tss;
+	/// Top of the kernel stack, also the TSS's RSP0.
+	uint64_t stack;
+	/// Tops of the IST stacks, also in the TSS. Each stack, like the
+	/// kernel stack, has an unmapped guard page below it.
+	uint64_t ist[ARC_CPU_IST_COUNT];
+	/// Thread pointer of the CPU's TLS block, for IA32_FS_BASE (0 if
+	/// the kernel has no PT_TLS segment).
+	uint64_t fs_base;
+}__attribute__((packed));
+
+/// What the bootstrapper used a module for.
+#define ARC_MODULE_OTHER     0
+#define ARC_MODULE_KERNEL    1
+#define ARC_MODULE_INITRAMFS 2
+#define ARC_MODULE_SNAPSHOT  3
+#define ARC_MODULE_BOOTPLAN  4
+#define ARC_MODULE_NAME_LEN 48
+
+/// Module handed over to the kernel.
+struct ARC_Module {
+	/// 32-bit FNV-1a hash of the module's full command line.
+	uint32_t name_hash;
+	/// ARC_MODULE_*.
+	uint32_t type;
+	/// Page aligned physical base of the module.
+	uint64_t paddr;
+	/// HHDM address of paddr.
+	uint64_t hhdm;
+	/// Size of the module in bytes.
+	uint64_t size;
+	/// Command line of the module, truncated and NUL terminated.
+	char name[ARC_MODULE_NAME_LEN];
+}__attribute__((packed));
+
+/// Set in crc32c_status for each module checked against a crc32c.* argument
+/// on the bootstrapper's command line, and for each which did not match.
+#define ARC_CRC32C_KERNEL_CHECKED    (1 << 0)
+#define ARC_CRC32C_KERNEL_BAD        (1 << 1)
+#define ARC_CRC32C_INITRAMFS_CHECKED (1 << 2)
+#define ARC_CRC32C_INITRAMFS_BAD     (1 << 3)
+
+/// Modules whose command line starts with this are relocatable ELF
+/// drivers, named by the rest of it.
+#define ARC_DRIVER_PREFIX "arctan-module.driver."
+/// Global function a driver may define, called by the kernel to start it.
+#define ARC_DRIVER_INIT "arc_driver_init"
+#define ARC_DRIVER_NAME_LEN 32
+
+/// Driver module loaded and relocated by the bootstrapper.
+struct ARC_DriverModule {
+	/// Base of the driver's image (vaddr). Read-only sections come first,
+	/// the writable ones start at base + data_offset.
+	uint64_t base;
+	/// Physical base of the image.
+	uint64_t paddr;
+	/// Size of the image in bytes.
+	uint64_t size;
+	uint64_t data_offset;
+	/// Address of the driver's ARC_DRIVER_INIT (vaddr, 0 if it has none).
+	uint64_t init;
+	/// Name of the driver, NUL terminated.
+	char name[ARC_DRIVER_NAME_LEN];
+}__attribute__((packed));
+
+/// Bytes at the thread pointer of each TLS block, the first quadword
+/// points to itself and the rest is zeroed.
+#define ARC_TLS_TCB_SIZE 0x40
+
+/// Exceptions taken between entering long mode and the kernel loading its IDT.
+struct ARC_CrashRecord {
+	/// Number of exceptions taken, the fields below describe the last one.
+	uint32_t count;
+	uint32_t vector;
+	uint64_t error_code;
+	uint64_t rip;
+	uint64_t cs;
+	uint64_t rflags;
+	uint64_t rsp;
+	uint64_t cr2;
+	/// TSC when the exception was taken.
+	uint64_t tsc;
+	/// Number of exceptions taken of each vector.
+	uint32_t vector_count[32];
+}__attribute__((packed));
+
+/// Memory map type of the boot record page.
+#define ARC_MEMORY_BOOT_RECORD 0x80
+/// Memory map type of data the loader handed over (modules, their
+/// command lines, the memory map), reclaimable once it is consumed.
+#define ARC_MEMORY_BOOT_DATA 0x81
+
+/// "BREC"
+#define ARC_BOOT_RECORD_MAGIC 0x43455242
+/// Number of boot attempts kept in the boot record.
+#define ARC_BOOT_RECORD_SLOTS 8
+
+/// The bootstrapper was entered.
+#define ARC_PHASE_ENTRY     0
+/// The boot information and memory map were read.
+#define ARC_PHASE_BOOT_INFO 1
+/// The ACPI tables were read.
+#define ARC_PHASE_ACPI      2
+/// The HHDM was created.
+#define ARC_PHASE_HHDM      3
+/// The kernel was loaded.
+#define ARC_PHASE_KERNEL    4
+/// Long mode is being entered to jump to the kernel.
+#define ARC_PHASE_HANDOFF   5
+#define ARC_PHASE_COUNT     6
+
+/// One boot attempt in the boot record.
+struct ARC_BootAttempt {
+	/// Number of the attempt, counting from 1 (0: the slot is unused).
+	uint32_t sequence;
+	/// Last phase reached (ARC_PHASE_*).
+	uint32_t phase;
+	/// TSC when each phase was reached, 0 if it was not.
+	uint64_t phase_tsc[ARC_PHASE_COUNT];
+	/// Exceptions caught in long mode before the kernel loaded its IDT.
+	struct ARC_CrashRecord crash;
+}__attribute__((packed));
+
+/// Ring of the last boot attempts, kept in a fixed page across resets.
+struct ARC_BootRecord {
+	uint32_t magic;
+	/// All bytes of the record sum to 0.
+	uint8_t checksum;
+	uint8_t reserved[3];
+	/// Number of attempts made.
+	uint32_t sequence;
+	/// Slot the next attempt goes into.
+	uint32_t next;
+	struct ARC_BootAttempt attempts[ARC_BOOT_RECORD_SLOTS];
+}__attribute__((packed));
+
+// The exception stubs in arch/x86/idt64.asm hard code these (CR_*, BR_*)
+_Static_assert(offsetof(struct ARC_CrashRecord, count) == 0, "CR_COUNT");
+_Static_assert(offsetof(struct ARC_CrashRecord, vector) == 4, "CR_VECTOR");
+_Static_assert(offsetof(struct ARC_CrashRecord, error_code) == 8, "CR_ERROR_CODE");
+_Static_assert(offsetof(struct ARC_CrashRecord, rip) == 16, "CR_RIP");
+_Static_assert(offsetof(struct ARC_CrashRecord, cs) == 24, "CR_CS");
+_Static_assert(offsetof(struct ARC_CrashRecord, rflags) == 32, "CR_RFLAGS");
+_Static_assert(offsetof(struct ARC_CrashRecord, rsp) == 40, "CR_RSP");
+_Static_assert(offsetof(struct ARC_CrashRecord, cr2) == 48, "CR_CR2");
+_Static_assert(offsetof(struct ARC_CrashRecord, tsc) == 56, "CR_TSC");
+_Static_assert(offsetof(struct ARC_CrashRecord, vector_count) == 64, "CR_VECTOR_COUNT");
+_Static_assert(offsetof(struct ARC_BootRecord, checksum) == 4, "BR_CHECKSUM");
+_Static_assert(sizeof(struct ARC_BootRecord) == 2000, "BR_SIZE");
+
+/// The CPU has no local APIC.
+#define ARC_APIC_NONE   0
+/// The local APIC is in xAPIC (MMIO) mode.
+#define ARC_APIC_XAPIC  1
+/// The local APIC is in x2APIC (MSR) mode.
+#define ARC_APIC_X2APIC 2
 
 struct ARC_KernMeta {
 
@@ -48,6 +418,24 @@ struct ARC_MMap {
 	uint64_t len;
 }__attribute__((packed));
 
+struct ARC_HHDMRange {
+	uint64_t base;
+	uint64_t len;
+	/// Memory type of the range (ARC_CACHE_*).
+	int cache;
+	/// Non-zero if the range is mapped read-only.
+	int read_only;
+}__attribute__((packed));
+
+struct ARC_KernSym {
+	/// Address of the function.
+	uint64_t addr;
+	/// Size of the function in bytes.
+	uint64_t size;
+	/// Offset of the name into the string table.
+	uint32_t name;
+}__attribute__((packed));
+
 struct ARC_BootMeta {
 	/// The boot protocol used.
 	int boot_proc;
@@ -63,7 +451,7 @@ struct ARC_BootMeta {
 	uint64_t initramfs;
 	/// The size of the initramfs module.
 	uint32_t initramfs_size;
-	/// State of the last kernel.
+	/// State of the last kernel (passed through a warm reboot, 0 on a cold boot).
 	uint64_t state;
 	/// Beginning of the HHDM (vaddr).
 	uint64_t hhdm_vaddr;
@@ -73,6 +461,157 @@ struct ARC_BootMeta {
 	int arc_mmap_len;
 	/// RSDP address.
 	uint64_t rsdp;
+	/// Zeroed page table frames for completing the HHDM (paddr, 0 if the HHDM is complete).
+	uint64_t hhdm_pool;
+	/// Number of frames in hhdm_pool.
+	int hhdm_pool_len;
+	/// Usable memory not yet mapped into the HHDM (paddr, of type struct ARC_MMap).
+	uint64_t hhdm_lazy;
+	/// Length of hhdm_lazy.
+	int hhdm_lazy_len;
+	/// How each range of physical memory is mapped into the HHDM (paddr, of type struct ARC_HHDMRange).
+	uint64_t hhdm_ranges;
+	/// Length of hhdm_ranges.
+	int hhdm_ranges_len;
+	/// Value programmed into IA32_PAT (0 if not supported).
+	uint64_t pat;
+	/// PML4 slot which maps the PML4 onto itself (-1: none).
+	int pt_recursive_slot;
+	/// Number of CPUs found in the MADT.
+	int cpu_count;
+	/// Base of the pre-mapped early kernel heap (vaddr).
+	uint64_t early_heap;
+	/// Physical base of early_heap.
+	uint64_t early_heap_paddr;
+	/// Size of early_heap in bytes (0 if there is none).
+	uint64_t early_heap_size;
+	/// Base of the pre-mapped per-CPU areas, one after the other in MADT order (vaddr).
+	uint64_t percpu;
+	/// Physical base of percpu.
+	uint64_t percpu_paddr;
+	/// Size of each per-CPU area in bytes (0 if there are none).
+	uint64_t percpu_size;
+	/// Number of PML1 tables freed by promoting 4 KiB pages to 2 MiB pages.
+	int pt_promoted;
+	/// Number of TLB entries saved by promoting pages.
+	int pt_tlb_saved;
+	/// The size of the kernel module (0 if it has been released to the PMM).
+	uint32_t kernel_elf_size;
+	/// Copy of the kernel's .symtab (paddr, 0 if the kernel has none).
+	uint64_t sym_table;
+	/// Size of sym_table in bytes.
+	uint32_t sym_table_size;
+	/// Copy of the kernel's .strtab (paddr).
+	uint64_t str_table;
+	/// HHDM address of str_table.
+	uint64_t str_table_hhdm;
+	/// Size of str_table in bytes.
+	uint32_t str_table_size;
+	/// Function symbols sorted by address (paddr, of type struct ARC_KernSym).
+	uint64_t sym_index;
+	/// HHDM address of sym_index.
+	uint64_t sym_index_hhdm;
+	/// Length of sym_index.
+	int sym_index_len;
+	/// Top of the kernel stack requested by ARC_NOTE_STACK_SIZE (vaddr, 0 if none).
+	uint64_t kernel_stack;
+	/// Size of kernel_stack in bytes, an unmapped guard page lies below it.
+	uint64_t kernel_stack_size;
+	/// CPU features found by the bootstrapper (ARC_NOTE_FEATURE_*).
+	uint32_t cpu_features;
+	/// Number of .altinstructions sites patched in the kernel.
+	int alt_patched;
+	/// Contiguous, zeroed frames page tables are allocated from in order (paddr, 0 if none).
+	uint64_t pt_arena;
+	/// Size of pt_arena in bytes.
+	uint64_t pt_arena_size;
+	/// Bytes of pt_arena handed out, the rest is zeroed and free for more tables.
+	/// Tables freed below this watermark are in the PMM's freelist.
+	uint64_t pt_arena_used;
+	/// Number of paging levels (4, or 5 if CR4.LA57 is set).
+	int pt_levels;
+	/// 64-bit entry point for warm reboots (paddr, called through the identity map
+	/// with the new kernel ELF's paddr in RDI, its size in RSI and the value for
+	/// state in RDX). The bootstrapper, its identity map and its HHDM tables must be
+	/// intact, everything else in the PMM's bounds is reclaimed.
+	uint64_t warm_entry;
+	/// Checksummed descriptor of the address space checked by warm_entry (paddr).
+	uint64_t warm_desc;
+	/// Pointer to the base of the snapshot module (0 if there is none).
+	uint64_t snapshot;
+	/// The size of the snapshot module.
+	uint32_t snapshot_size;
+	/// Pointer to the base of the boot plan module (0 if there is none).
+	uint64_t boot_plan;
+	/// The size of the boot plan module.
+	uint32_t boot_plan_size;
+	/// Non-zero if the kernel was loaded from boot_plan.
+	int boot_plan_used;
+	/// Array of ARC_CPUDesc, one per CPU counted in cpu_count (vaddr, 0 if none).
+	uint64_t cpu_desc;
+	/// Physical base of cpu_desc.
+	uint64_t cpu_desc_paddr;
+	/// Number of entries in cpu_desc.
+	int cpu_desc_count;
+	/// Mode the BSP's local APIC was left in (ARC_APIC_*).
+	int apic_mode;
+	/// APIC ID of the BSP.
+	uint32_t bsp_apic_id;
+	/// CPU index (as in cpu_desc) of each APIC ID, 0xFFFFFFFF if there is no
+	/// such CPU (paddr, of type uint32_t, 0 if none).
+	uint64_t apic_map;
+	/// HHDM address of apic_map.
+	uint64_t apic_map_hhdm;
+	/// Length of apic_map, the highest APIC ID plus one.
+	uint32_t apic_map_len;
+	/// Exceptions caught before the kernel loaded its IDT (paddr, of type
+	/// struct ARC_CrashRecord).
+	uint64_t crash_record;
+	/// Boot record kept across resets (paddr, of type struct ARC_BootRecord,
+	/// 0 if none). Its page is of type ARC_MEMORY_BOOT_RECORD in arc_mmap.
+	uint64_t boot_record;
+	/// Slot of this boot attempt in boot_record.
+	int boot_record_slot;
+	/// Number of earlier attempts found in boot_record, 0 if it was invalid.
+	int boot_record_found;
+	/// TLS blocks made from the kernel's PT_TLS segment, one per CPU counted
+	/// in cpu_count (vaddr, 0 if none). The BSP's FS base points into the first.
+	uint64_t tls;
+	/// Physical base of tls.
+	uint64_t tls_paddr;
+	/// Bytes between the start of one CPU's TLS block and the next.
+	uint32_t tls_stride;
+	/// Offset of the thread pointer (see ARC_TLS_TCB_SIZE) in each block.
+	uint32_t tls_offset;
+	/// Drivers loaded in module order, placed one after another after the
+	/// kernel's image (paddr, of type struct ARC_DriverModule, 0 if none).
+	uint64_t drivers;
+	/// HHDM address of drivers.
+	uint64_t drivers_hhdm;
+	/// Length of drivers.
+	int driver_count;
+	/// Modules checked against their expected CRC32C (ARC_CRC32C_*).
+	uint32_t crc32c_status;
+	/// CRC32C of the kernel module (0 if it was not checked).
+	uint32_t kernel_crc32c;
+	/// CRC32C of the initramfs (0 if it was not checked).
+	uint32_t initramfs_crc32c;
+	/// TSC cycles spent computing the CRC32Cs.
+	uint64_t crc32c_tsc;
+	/// Every module still in memory, in the order they were given (paddr, of
+	/// type struct ARC_Module, 0 if none). Drivers are in drivers instead.
+	/// module_slots uint16_t follow the entries, slot name_hash & (module_slots - 1)
+	/// and those after it hold entry indices plus one, up to an empty (0) slot.
+	uint64_t modules;
+	/// HHDM address of modules.
+	uint64_t modules_hhdm;
+	/// Length of modules.
+	int module_count;
+	/// Number of hash slots after modules, a power of two.
+	uint32_t module_slots;
 }__attribute__((packed));
 
+// src/asm/boot.asm reserves BOOT_MEMBER_COUNT (64) qwords for _boot_meta
+_Static_assert(sizeof(struct ARC_BootMeta) <= 64 * 8, "BOOT_MEMBER_COUNT");
+
 #endif
@@ -0,0 +1,75 @@
+/**
+ * @file driver.h
+ *
+ * @author awewsomegamer <awewsomegamer@gmail.com>
+ *
+ * @LICENSE
+ * Arctan-MB2BSP - Multiboot2 Bootstrapper for Arctan Kernel
+ * Copyright (C) 2023-2024 awewsomegamer
+ *
+ * This file is part of Arctan-MB2BSP
+ *
+ * Arctan is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; version 2
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * @DESCRIPTION
+ * Loader for relocatable ELF driver modules.
+*/
+#ifndef ARC_ELF_DRIVER_H
+#define ARC_ELF_DRIVER_H
+
+#include <global.h>
+
+/// Most driver modules which can be loaded.
+#define ARC_DRIVER_MAX 32
+
+/**
+ * Record a driver module.
+ *
+ * Must be called for every module before the PMM is initialized.
+ *
+ * @param char *cmdline - Command line of the module.
+ * @param uint64_t paddr - Physical base of the module.
+ * @param uint64_t size - Size of the module in bytes.
+ * @return 0 if the module is a driver (see ARC_DRIVER_PREFIX), even if
+ * it cannot be loaded, -1 if it is not.
+ * */
+int driver_add(char *cmdline, uint64_t paddr, uint64_t size);
+
+/**
+ * Estimate the page tables load_drivers will need.
+ *
+ * @return The number of tables (see count_tables).
+ * */
+int driver_count_tables();
+
+/**
+ * Load every recorded driver module.
+ *
+ * The allocated sections of all drivers are laid out one after
+ * another from the first 2 MiB boundary after the kernel's image,
+ * read-only sections before writable ones, and copied into one
+ * physically contiguous region. Symbols the drivers leave undefined
+ * are resolved against the kernel's global symbols through a hash
+ * table built once for all drivers. A driver with an unresolved
+ * symbol or a relocation which cannot be applied is left out.
+ *
+ * The loaded drivers are handed over in _boot_meta.drivers and
+ * their modules are released to the PMM. Must be called after the
+ * kernel is loaded, while its module is still present.
+ *
+ * @return Error code (0: success, there may be no drivers).
+ * */
+int load_drivers();
+
+#endif
@@ -30,12 +30,112 @@
 
 #include <global.h>
 
+#ifndef ARC_ELF_RELOCATE
+/// Copy PT_LOAD segments into 2 MiB aligned memory instead of mapping them in place.
+#define ARC_ELF_RELOCATE 0
+#endif
+
+struct ARC_KernelNotes {
+	/// Bitmask of the notes found (1 << ARC_NOTE_*).
+	uint32_t present;
+	uint64_t hhdm_base;
+	uint64_t page_sizes;
+	uint64_t early_heap_size;
+	uint64_t stack_size;
+	uint64_t features;
+	uint64_t paging_levels;
+};
+
+/// The kernel's PT_TLS segment.
+struct ARC_KernelTLS {
+	/// Offset of the initialization image (.tdata) in the file.
+	uint64_t offset;
+	/// Size of the initialization image.
+	uint64_t file_size;
+	/// Size of the whole block, the rest (.tbss) is zeroed.
+	uint64_t mem_size;
+	uint64_t align;
+};
+
+/// Requirements declared by the kernel, filled in by read_elf_notes.
+extern struct ARC_KernelNotes kernel_notes;
+
+/**
+ * Estimate the page tables load_elf will need for the file.
+ *
+ * @param void *file - 32-bit physical pointer to the start of the ELF file.
+ * @return The number of tables (see count_tables).
+ * */
+int elf_count_tables(void *file);
+
+/**
+ * Describe a PT_LOAD segment of the file.
+ *
+ * @param void *file - 32-bit physical pointer to the start of the ELF file.
+ * @param int index - Index of the program header.
+ * @param uint64_t *vaddr - Set to the address of the segment.
+ * @param uint64_t *size - Set to the size of the segment in memory.
+ * @param int *writable - Set to 1 if the segment is writable.
+ * @return 0 if the header is a loaded segment, 1 if it is not, -1 past
+ * the last header.
+ * */
+int elf_segment(void *file, int index, uint64_t *vaddr, uint64_t *size, int *writable);
+
+/**
+ * Find the kernel's TLS template.
+ *
+ * @param void *file - 32-bit physical pointer to the start of the ELF file.
+ * @param struct ARC_KernelTLS *tls - Filled in with the PT_TLS segment.
+ * @return 0 if the file has a non-empty PT_TLS segment.
+ * */
+int elf_tls(void *file, struct ARC_KernelTLS *tls);
+
+/**
+ * Read the kernel's "Arctan" notes.
+ *
+ * Walks every PT_NOTE segment of the file and records each note
+ * owned by ARC_NOTE_OWNER in kernel_notes. Must be called before
+ * the address space is built, so the notes can be honoured.
+ *
+ * @param void *file - 32-bit physical pointer to the start of the ELF file.
+ * @return Error code (0: success, the file may have no notes).
+ * */
+int read_elf_notes(void *file);
+
+/**
+ * Hash the ELF header and program headers of the file.
+ *
+ * Used to tell if a boot plan was made from the file, must match
+ * tools/bootplan.
+ *
+ * @param void *file - 32-bit physical pointer to the start of the ELF file.
+ * @return 32-bit FNV-1a hash.
+ * */
+uint32_t elf_header_hash(void *file);
+
+/**
+ * Finish loading a kernel which was mapped without load_elf.
+ *
+ * Copies out the symbol table and patches alternatives, as
+ * load_elf does.
+ *
+ * @param uint64_t *pml4 - Page map the kernel is mapped in.
+ * @param void *file - 32-bit physical pointer to the start of the ELF file.
+ * @return Error code (0: success).
+ * */
+int finish_elf(uint64_t *pml4, void *file);
+
 /**
  * Simple ELF64 loader.
  *
  * Very simple ELF loader function for loading a
  * higher-half kernel.
  *
+ * If ARC_ELF_RELOCATE is set, the PT_LOAD segments are copied
+ * into a single physically contiguous, 2 MiB aligned extent and
+ * mapped with large pages where possible, after which the file
+ * itself is no longer needed.
+ *
  * @param uint64_t *pml4 - Current PML4 page map to map the file into.
  * @param void *file - 32-bit physical pointer to the start of the ELF file.
  * @return Address at which the file was loaded. Files cannot be loaded at
@@ -0,0 +1,157 @@
+/**
+ * @file elf64.h
+ *
+ * @author awewsomegamer <awewsomegamer@gmail.com>
+ *
+ * @LICENSE
+ * Arctan-MB2BSP - Multiboot2 Bootstrapper for Arctan Kernel
+ * Copyright (C) 2023-2024 awewsomegamer
+ *
+ * This file is part of Arctan-MB2BSP
+ *
+ * Arctan is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; version 2
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * @DESCRIPTION
+ * ELF64 structures and constants, shared by the kernel and driver loaders.
+*/
+#ifndef ARC_ELF_ELF64_H
+#define ARC_ELF_ELF64_H
+
+#include <stdint.h>
+
+#define SHT_NULL 0
+#define SHT_PROGBITS 1
+#define SHT_SYMTAB 2
+#define SHT_STRTAB 3
+#define SHT_RELA 4
+#define SHT_HASH 5
+#define SHT_DYNAMIC 6
+#define SHT_NOTE 7
+#define SHT_NOBITS 8
+#define SHT_REL 9
+#define SHT_SHLIB 10
+#define SHT_DYNSYM 11
+
+#define SHF_WRITE 1
+#define SHF_ALLOC 2
+#define SHF_TLS 0x400
+
+#define SHN_UNDEF 0
+#define SHN_ABS 0xFFF1
+#define SHN_COMMON 0xFFF2
+
+#define STT_FUNC 2
+#define STB_GLOBAL 1
+#define STB_WEAK 2
+#define ELF64_ST_TYPE(info) ((info) & 0xF)
+#define ELF64_ST_BIND(info) ((info) >> 4)
+
+#define ET_REL 1
+#define EM_X86_64 62
+
+#define R_X86_64_NONE 0
+#define R_X86_64_64 1
+#define R_X86_64_PC32 2
+#define R_X86_64_PLT32 4
+#define R_X86_64_32 10
+#define R_X86_64_32S 11
+#define R_X86_64_PC64 24
+#define ELF64_R_SYM(info) ((info) >> 32)
+#define ELF64_R_TYPE(info) ((uint32_t)(info))
+
+#define PT_NULL 0
+#define PT_LOAD 1
+#define PT_NOTE 4
+#define PT_TLS 7
+
+#define PF_X 1
+#define PF_W 2
+#define PF_R 4
+
+typedef uint64_t Elf64_Addr;
+typedef uint64_t Elf64_Off;
+typedef uint16_t Elf64_Half;
+typedef uint32_t Elf64_Word;
+typedef uint32_t Elf64_Sword;
+typedef uint64_t Elf64_Xword;
+typedef uint64_t Elf64_Sxword;
+
+struct Elf64_Ehdr {
+	unsigned char e_ident[16]; /* ELF identification */
+	Elf64_Half e_type; /* Object file type */
+	Elf64_Half e_machine; /* Machine type */
+	Elf64_Word e_version; /* Object file version */
+	Elf64_Addr e_entry; /* Entry point address */
+	Elf64_Off e_phoff; /* Program header offset */
+	Elf64_Off e_shoff; /* Section header offset */
+	Elf64_Word e_flags; /* Processor-specific flags */
+	Elf64_Half e_ehsize; /* ELF header size */
+	Elf64_Half e_phentsize; /* Size of program header entry */
+	Elf64_Half e_phnum; /* Number of program header entries */
+	Elf64_Half e_shentsize; /* Size of section header entry */
+	Elf64_Half e_shnum; /* Number of section header entries */
+	Elf64_Half e_shstrndx; /* Section name string table index */
+}__attribute__((packed));
+
+struct Elf64_Shdr {
+	Elf64_Word sh_name; /* Section name */
+	Elf64_Word sh_type; /* Section type */
+	Elf64_Xword sh_flags; /* Section attributes */
+	Elf64_Addr sh_addr; /* Virtual address in memory */
+	Elf64_Off sh_offset; /* Offset in file */
+	Elf64_Xword sh_size; /* Size of section */
+	Elf64_Word sh_link; /* Link to other section */
+	Elf64_Word sh_info; /* Miscellaneous information */
+	Elf64_Xword sh_addralign; /* Address alignment boundary */
+	Elf64_Xword sh_entsize; /* Size of entries, if section has table */
+}__attribute__((packed));
+
+struct Elf64_Sym {
+	Elf64_Word st_name; /* Symbol name */
+	unsigned char st_info; /* Type and Binding attributes */
+	unsigned char st_other; /* Reserved */
+	Elf64_Half st_shndx; /* Section table index */
+	Elf64_Addr st_value; /* Symbol value */
+	Elf64_Xword st_size; /* Size of object (e.g., common) */
+}__attribute__((packed));
+
+struct Elf64_Rel {
+	Elf64_Addr r_offset; /* Address of reference */
+	Elf64_Xword r_info; /* Symbol index and type of relocation */
+}__attribute__((packed));
+
+struct Elf64_Rela {
+	Elf64_Addr r_offset; /* Address of reference */
+	Elf64_Xword r_info; /* Symbol index and type of relocation */
+	Elf64_Sxword r_addend; /* Constant part of expression */
+}__attribute__((packed));
+
+struct Elf64_Phdr {
+	Elf64_Word p_type; /* Type of segment */
+	Elf64_Word p_flags; /* Segment attributes */
+	Elf64_Off p_offset; /* Offset in file */
+	Elf64_Addr p_vaddr; /* Virtual address in memory */
+	Elf64_Addr p_paddr; /* Reserved */
+	Elf64_Xword p_filesz; /* Size of segment in file */
+	Elf64_Xword p_memsz; /* Size of segment in memory */
+	Elf64_Xword p_align; /* Alignment of segment */
+}__attribute__((packed));
+
+struct Elf64_Nhdr {
+	Elf64_Word n_namesz; /* Size of the name */
+	Elf64_Word n_descsz; /* Size of the descriptor */
+	Elf64_Word n_type; /* Type of the note */
+}__attribute__((packed));
+
+#endif
@@ -0,0 +1,59 @@
+/**
+ * @file plan.h
+ *
+ * @author awewsomegamer <awewsomegamer@gmail.com>
+ *
+ * @LICENSE
+ * Arctan-MB2BSP - Multiboot2 Bootstrapper for Arctan Kernel
+ * Copyright (C) 2023-2024 awewsomegamer
+ *
+ * This file is part of Arctan-MB2BSP
+ *
+ * Arctan is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; version 2
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * @DESCRIPTION
+ * Loading the kernel from a boot plan made by tools/bootplan.
+*/
+#ifndef ARC_ELF_PLAN_H
+#define ARC_ELF_PLAN_H
+
+#include <global.h>
+
+/**
+ * Count the page tables of the boot plan in _boot_meta.boot_plan.
+ *
+ * @return The number of tables the plan brings, 0 if there is no
+ * plan or it cannot be used for the kernel in _boot_meta.kernel_elf.
+ * */
+int plan_count_tables();
+
+/**
+ * Load the kernel from the boot plan in _boot_meta.boot_plan.
+ *
+ * The plan's tables are copied into freshly allocated frames and
+ * their references to each other and to the image are patched,
+ * then the image is copied out of the kernel file and its root
+ * entries are installed. Nothing is written unless the plan was made
+ * for this kernel, paging mode and page sizes, and all of its root
+ * slots are free in pml4, so load_elf can be used if it fails.
+ *
+ * finish_elf must still be called for the file.
+ *
+ * @param uint64_t *pml4 - Page map to install the kernel into.
+ * @param void *file - 32-bit physical pointer to the start of the ELF file.
+ * @return The kernel's entry point, 0 if the plan was not used.
+ * */
+uint64_t load_plan(uint64_t *pml4, void *file);
+
+#endif
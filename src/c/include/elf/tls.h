@@ -0,0 +1,70 @@
+/**
+ * @file tls.h
+ *
+ * @author awewsomegamer <awewsomegamer@gmail.com>
+ *
+ * @LICENSE
+ * Arctan-MB2BSP - Multiboot2 Bootstrapper for Arctan Kernel
+ * Copyright (C) 2023-2024 awewsomegamer
+ *
+ * This file is part of Arctan-MB2BSP
+ *
+ * Arctan is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; version 2
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * @DESCRIPTION
+ * Per-CPU TLS blocks made from the kernel's PT_TLS segment.
+*/
+#ifndef ARC_ELF_TLS_H
+#define ARC_ELF_TLS_H
+
+#include <global.h>
+
+/// Virtual base of the per-CPU TLS blocks.
+#define ARC_TLS_VADDR 0xFFFFFEB000000000
+
+/**
+ * Estimate the page tables create_tls_blocks will need.
+ *
+ * @return The number of tables (see count_tables).
+ * */
+int tls_count_tables();
+
+/**
+ * Create a TLS block for every CPU from the kernel's PT_TLS segment.
+ *
+ * One block per CPU in _boot_meta.cpu_count is laid out for the
+ * x86-64 TLS ABI (variant II): the initialization image is copied
+ * to the start of each block, the rest of the segment is zeroed
+ * and the thread pointer follows it, pointing to an
+ * ARC_TLS_TCB_SIZE byte TCB which starts with a pointer to itself.
+ * Blocks are 64-byte aligned so no two CPUs share a cache line. All
+ * of them are carved out of one physically contiguous region,
+ * mapped at ARC_TLS_VADDR and described in _boot_meta.tls.
+ *
+ * Must be called while the kernel's module is still present.
+ *
+ * @param void *file - 32-bit physical pointer to the start of the ELF file.
+ * @return Error code (0: success, the kernel may have no PT_TLS segment).
+ * */
+int create_tls_blocks(void *file);
+
+/**
+ * Get the thread pointer of a CPU.
+ *
+ * @param int cpu - Index of the CPU.
+ * @return Value for the CPU's IA32_FS_BASE, 0 if there are no TLS blocks.
+ * */
+uint64_t tls_pointer(int cpu);
+
+#endif
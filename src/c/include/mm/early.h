@@ -0,0 +1,73 @@
+/**
+ * @file early.h
+ *
+ * @author awewsomegamer <awewsomegamer@gmail.com>
+ *
+ * @LICENSE
+ * Arctan-MB2BSP - Multiboot2 Bootstrapper for Arctan Kernel
+ * Copyright (C) 2023-2024 awewsomegamer
+ *
+ * This file is part of Arctan-MB2BSP
+ *
+ * Arctan is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; version 2
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * @DESCRIPTION
+ * Pre-mapped early kernel heap and per-CPU areas.
+*/
+#ifndef ARC_MM_EARLY_H
+#define ARC_MM_EARLY_H
+
+#include <global.h>
+
+#ifndef ARC_EARLY_HEAP_SIZE
+/// Size in bytes of the early kernel heap (0: none).
+#define ARC_EARLY_HEAP_SIZE 0x4000000
+#endif
+
+#ifndef ARC_PERCPU_SIZE
+/// Size in bytes of each per-CPU area (0: none).
+#define ARC_PERCPU_SIZE 0x10000
+#endif
+
+/// Virtual base of the early kernel heap.
+#define ARC_EARLY_HEAP_VADDR 0xFFFFFE8000000000
+/// Virtual base of the per-CPU areas.
+#define ARC_PERCPU_VADDR     0xFFFFFEC000000000
+/// Virtual base of the kernel stack, starting with its guard page.
+#define ARC_KERNEL_STACK_VADDR 0xFFFFFEE000000000
+
+/**
+ * Estimate the page tables map_early_regions will need.
+ *
+ * @return The number of tables (see count_tables).
+ * */
+int early_count_tables();
+
+/**
+ * Allocate and map the early kernel heap and per-CPU areas.
+ *
+ * Both are backed by 2 MiB aligned physical memory and mapped
+ * with 2 MiB pages, so the kernel can use them without any page
+ * faults or table allocations. One per-CPU area is made for
+ * each CPU in _boot_meta.cpu_count.
+ *
+ * The kernel's ARC_NOTE_EARLY_HEAP note overrides ARC_EARLY_HEAP_SIZE,
+ * and its ARC_NOTE_STACK_SIZE note has a stack mapped for it above
+ * an unmapped guard page.
+ *
+ * @return Error code (0: success).
+ * */
+int map_early_regions();
+
+#endif
@@ -40,6 +40,8 @@ struct ARC_FreelistMeta {
 	struct ARC_FreelistNode *base __attribute__((aligned(8)));
 	struct ARC_FreelistNode *ciel __attribute__((aligned(8)));
 	uint64_t object_size __attribute__((aligned(8)));
+	/// Highest object ever allocated, the list may be freed into in any order.
+	struct ARC_FreelistNode *highest __attribute__((aligned(8)));
 }__attribute__((packed));
 
 /**
@@ -59,6 +61,20 @@ void *Arc_ListAlloc(struct ARC_FreelistMeta *meta);
  * */
 void *Arc_ListContiguousAlloc(struct ARC_FreelistMeta *meta, int objects);
 
+/**
+ * Allocate an aligned, contiguous section of memory.
+ *
+ * Unlike Arc_ListContiguousAlloc, the list is searched for a
+ * suitable run of free objects, objects before the run are left
+ * in the list.
+ *
+ * @param struct ARC_FreelistMeta *meta - The list in which to allocate the contiguous region of memory.
+ * @param int objects - Number of contiguous objects to allocate.
+ * @param uintptr_t align - Alignment of the base address, must be a power of two.
+ * @return The base address of the contiguous section, NULL if none was found.
+ * */
+void *Arc_ListContiguousAlignedAlloc(struct ARC_FreelistMeta *meta, int objects, uintptr_t align);
+
 /**
  * Free the object at the given address in the given meta.
  *
@@ -0,0 +1,113 @@
+/**
+ * @file hhdm.h
+ *
+ * @author awewsomegamer <awewsomegamer@gmail.com>
+ *
+ * @LICENSE
+ * Arctan-MB2BSP - Multiboot2 Bootstrapper for Arctan Kernel
+ * Copyright (C) 2023-2024 awewsomegamer
+ *
+ * This file is part of Arctan-MB2BSP
+ *
+ * Arctan is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; version 2
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * @DESCRIPTION
+ * Higher half direct map (HHDM) construction.
+*/
+#ifndef ARC_MM_HHDM_H
+#define ARC_MM_HHDM_H
+
+#include <global.h>
+
+/// Base of the HHDM unless the kernel asks for another (ARC_NOTE_HHDM_BASE).
+#define ARC_HHDM_BASE 0xFFFFC00000000000
+/// Base of the HHDM with five-level paging, the first higher half PML5 slot.
+#define ARC_HHDM_BASE_LA57 0xFF00000000000000
+
+#ifndef ARC_HHDM_EAGER_SIZE
+/// Bytes of usable RAM to eagerly map into the HHDM (0: map all of it).
+#define ARC_HHDM_EAGER_SIZE 0
+#endif
+
+#ifndef ARC_HHDM_POOL_PAGES
+/// Number of zeroed page table frames handed to the kernel if the HHDM is partial.
+#define ARC_HHDM_POOL_PAGES 64
+#endif
+
+#ifndef ARC_HHDM_MAX_MMIO
+/// Maximum number of MMIO windows which can be mapped into the HHDM.
+#define ARC_HHDM_MAX_MMIO 32
+#endif
+
+/**
+ * Register an MMIO window to be mapped into the HHDM.
+ *
+ * Must be called before create_hhdm.
+ *
+ * @param uint64_t base - Physical base of the window.
+ * @param uint64_t len - Length of the window in bytes.
+ * @param int cache - Memory type to map the window with (ARC_CACHE_*).
+ * @return Error code (0: success).
+ * */
+int hhdm_add_mmio(uint64_t base, uint64_t len, int cache);
+
+/**
+ * Estimate the page tables create_hhdm will need.
+ *
+ * Includes the pool handed to the kernel if the HHDM is partial.
+ *
+ * @return The number of tables (see count_tables).
+ * */
+int hhdm_count_tables();
+
+/**
+ * Create the HHDM from _boot_meta.arc_mmap.
+ *
+ * The HHDM is placed at _boot_meta.hhdm_vaddr, or at ARC_HHDM_BASE
+ * if it is not set.
+ *
+ * Usable RAM and ACPI NVS are mapped write-back, ACPI tables are
+ * mapped write-back and read-only, registered MMIO windows are
+ * mapped with their own memory type, everything else is left out.
+ * A table of these ranges is handed off in _boot_meta.hhdm_ranges.
+ *
+ * If ARC_HHDM_EAGER_SIZE is non-zero, only that many bytes of
+ * usable RAM (and everything the bootstrapper has used so far) are
+ * mapped, the rest is left for the kernel to map on demand.
+ *
+ * @return Error code (0: success).
+ * */
+int create_hhdm();
+
+/**
+ * Finish the HHDM before handing off to the kernel.
+ *
+ * Maps any memory the bootstrapper used since create_hhdm and records
+ * the usable ranges which remain unmapped in _boot_meta.
+ *
+ * @return Error code (0: success).
+ * */
+int finalize_hhdm();
+
+/**
+ * Give the kernel a fresh page table pool after a warm reboot.
+ *
+ * The previous kernel may have taken tables from the pool, those
+ * that map the HHDM are kept by rebuild_pmm and the rest are freed.
+ *
+ * @return Error code (0: success).
+ * */
+int renew_hhdm_pool();
+
+#endif
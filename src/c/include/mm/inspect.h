@@ -0,0 +1,49 @@
+/**
+ * @file inspect.h
+ *
+ * @author awewsomegamer <awewsomegamer@gmail.com>
+ *
+ * @LICENSE
+ * Arctan-MB2BSP - Multiboot2 Bootstrapper for Arctan Kernel
+ * Copyright (C) 2023-2024 awewsomegamer
+ *
+ * This file is part of Arctan-MB2BSP
+ *
+ * Arctan is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; version 2
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * @DESCRIPTION
+ * Debug checks of the page tables handed to the kernel.
+*/
+#ifndef ARC_MM_INSPECT_H
+#define ARC_MM_INSPECT_H
+
+#include <global.h>
+
+/**
+ * Check and describe the page tables.
+ *
+ * Prints the number of tables and pages at every level and every
+ * range mapped. Reports mappings and tables on free frames, frames
+ * mapped more than once outside of the HHDM, kernel segments mapped
+ * with the wrong permissions and usable memory which is neither in
+ * the HHDM nor in _boot_meta.hhdm_lazy.
+ *
+ * Only frames below 4 GiB are checked for being free or mapped twice.
+ *
+ * @param uint64_t *pml4 - Root table to check.
+ * @return Number of problems found.
+ * */
+int inspect_tables(uint64_t *pml4);
+
+#endif
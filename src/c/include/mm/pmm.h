@@ -30,17 +30,57 @@
 
 #include <multiboot/multiboot2.h>
 #include <mm/freelist.h>
+#include <arctan.h>
+
+/// Largest memory map a boot protocol parser can hand to init_pmm.
+#define ARC_PMM_MAX_MMAP 128
 
 /**
  * Initialize the PMM.
  *
  * Finds free regions of memory in the 32-bit address range
- * and initializes them into freelists.
+ * and initializes them into freelists. The memory map is then
+ * copied into memory of its own and handed off in _boot_meta.
+ *
+ * Entry types are MULTIBOOT_MEMORY_*, which match the E820 types.
  *
- * @param struct multiboot_tag_mmap *mmap - The MMAP tag provided by GRUB.
+ * @param struct ARC_MMap *mmap - The memory map provided by the boot protocol.
+ * @param int entries - Number of entries in mmap.
  * @param uintptr_t bootstrap_end - The highest address used by the bootstrapper.
  * @return Error code (0: success).
  * */
-int init_pmm(struct multiboot_tag_mmap *mmap, uintptr_t bootstrap_end);
+int init_pmm(struct ARC_MMap *mmap, int entries, uintptr_t bootstrap_end);
+
+/**
+ * Give a range of available memory a type of its own.
+ *
+ * The MULTIBOOT_MEMORY_AVAILABLE entry holding the range is split
+ * into up to three entries, the middle one of the given type.
+ *
+ * @param struct ARC_MMap *mmap - Memory map, ARC_PMM_MAX_MMAP entries long.
+ * @param int entries - Number of entries used.
+ * @param uint64_t base - Base of the range.
+ * @param uint64_t len - Length of the range.
+ * @param int type - Type of the range.
+ * @return The new number of entries, -1 if the range is not available
+ * memory or the map is full.
+ * */
+int pmm_split_mmap(struct ARC_MMap *mmap, int entries, uint64_t base, uint64_t len, int type);
+
+/**
+ * Give memory the PMM was never initialized with to the PMM.
+ *
+ * Used to free modules once they are no longer needed. Only the
+ * whole pages within the range are released, they must lie in a
+ * MULTIBOOT_MEMORY_AVAILABLE or ARC_MEMORY_BOOT_DATA entry of
+ * _boot_meta.arc_mmap and below
+ * the ceiling of the freelist. The base of the freelist is lowered
+ * to the range if needed.
+ *
+ * @param uint64_t base - Base of the memory.
+ * @param uint64_t size - Size of the memory in bytes.
+ * @return Error code (0: success).
+ * */
+int pmm_release(uint64_t base, uint64_t size);
 
 #endif
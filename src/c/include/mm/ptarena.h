@@ -0,0 +1,81 @@
+/**
+ * @file ptarena.h
+ *
+ * @author awewsomegamer <awewsomegamer@gmail.com>
+ *
+ * @LICENSE
+ * Arctan-MB2BSP - Multiboot2 Bootstrapper for Arctan Kernel
+ * Copyright (C) 2023-2024 awewsomegamer
+ *
+ * This file is part of Arctan-MB2BSP
+ *
+ * Arctan is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; version 2
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * @DESCRIPTION
+ * Contiguous arena of zeroed page tables.
+*/
+#ifndef ARC_MM_PTARENA_H
+#define ARC_MM_PTARENA_H
+
+#include <global.h>
+
+#ifndef ARC_PT_ARENA_SLACK
+/// Page tables reserved on top of the estimate, for splitting large pages.
+#define ARC_PT_ARENA_SLACK 16
+#endif
+
+/**
+ * Reserve the page table arena.
+ *
+ * Estimates how many tables the identity map, HHDM, kernel and
+ * early regions can need from _boot_meta.arc_mmap, the kernel's
+ * program headers and the mapping policy, and reserves that many
+ * zeroed, physically contiguous frames. Must be called before
+ * anything is mapped. The bounds and watermark of the arena are
+ * handed off in _boot_meta, so the kernel can keep using it.
+ *
+ * @return Error code (0: success).
+ * */
+int create_table_arena();
+
+/**
+ * Allocate zeroed page tables.
+ *
+ * Tables are handed out in order from the arena, once it is
+ * exhausted (or if there is none) they come from the PMM.
+ *
+ * @param int count - Number of physically contiguous tables.
+ * @return 32-bit physical pointer to the first table, NULL on failure.
+ * */
+void *alloc_tables(int count);
+
+/**
+ * Free a page table.
+ *
+ * The most recently allocated arena table is zeroed and returned
+ * to the arena, any other table goes back to the PMM.
+ *
+ * @param void *table - 32-bit physical pointer to the table.
+ * */
+void free_table(void *table);
+
+/**
+ * Check if a table was allocated from the arena.
+ *
+ * @param void *table - 32-bit physical pointer to the table.
+ * @return 1 if the table lies within the arena, 0 otherwise.
+ * */
+int in_table_arena(void *table);
+
+#endif
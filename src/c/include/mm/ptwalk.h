@@ -0,0 +1,99 @@
+/**
+ * @file ptwalk.h
+ *
+ * @author awewsomegamer <awewsomegamer@gmail.com>
+ *
+ * @LICENSE
+ * Arctan-MB2BSP - Multiboot2 Bootstrapper for Arctan Kernel
+ * Copyright (C) 2023-2024 awewsomegamer
+ *
+ * This file is part of Arctan-MB2BSP
+ *
+ * Arctan is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; version 2
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * @DESCRIPTION
+ * Page table walker shared by the bootstrapper and tools/ptinspect.
+*/
+#ifndef ARC_MM_PTWALK_H
+#define ARC_MM_PTWALK_H
+
+// Also built for the host, so only freestanding headers may be included
+#include <stddef.h>
+#include <stdint.h>
+
+/// Physical address bits of an entry.
+#define ARC_PT_ADDRESS 0x000FFFFFFFFFF000ULL
+/// Flags reported for a range. Write and user are set only if every
+/// level allows them, no-execute if any level sets it. PAT is moved
+/// to bit 7 for every page size.
+#define ARC_PT_WRITE (1ULL << 1)
+#define ARC_PT_USER  (1ULL << 2)
+#define ARC_PT_PWT   (1ULL << 3)
+#define ARC_PT_PCD   (1ULL << 4)
+#define ARC_PT_PAT   (1ULL << 7)
+#define ARC_PT_GLOBAL (1ULL << 8)
+#define ARC_PT_NX    (1ULL << 63)
+
+struct ARC_PTWalk {
+	/// Number of paging levels (4 or 5).
+	int levels;
+	/// Return a pointer to the table at paddr, NULL if it cannot be read.
+	uint64_t *(*read)(uint64_t paddr, void *ctx);
+	/// Called for every table reached, may be NULL.
+	void (*table)(int level, uint64_t paddr, void *ctx);
+	/// Called for every run of contiguous leaf mappings with the same
+	/// flags, in ascending order of vaddr, may be NULL.
+	void (*range)(uint64_t vaddr, uint64_t paddr, uint64_t size, uint64_t flags, void *ctx);
+	void *ctx;
+
+	/// Tables reached at each level (index 1 to 5).
+	uint32_t tables[6];
+	/// Pages mapped of each size (4 KiB, 2 MiB, 1 GiB).
+	uint64_t pages[3];
+	/// Tables which could not be read.
+	uint32_t unreadable;
+	/// Entries pointing back at the root table, which are not followed.
+	uint32_t recursive;
+
+	// Run being coalesced
+	uint64_t run_vaddr;
+	uint64_t run_paddr;
+	uint64_t run_size;
+	uint64_t run_flags;
+};
+
+/**
+ * Walk every table reachable from root.
+ *
+ * Statistics are reset first. levels, read and ctx must be set.
+ *
+ * @param struct ARC_PTWalk *walk - Walk to carry out.
+ * @param uint64_t root - Physical address of the root table.
+ * */
+void pt_walk(struct ARC_PTWalk *walk, uint64_t root);
+
+/**
+ * Look up the mapping of a single address.
+ *
+ * @param struct ARC_PTWalk *walk - levels, read and ctx must be set.
+ * @param uint64_t root - Physical address of the root table.
+ * @param uint64_t vaddr - Address to look up.
+ * @param uint64_t *paddr - Set to the address vaddr maps to.
+ * @param uint64_t *flags - Set to the flags of the page (ARC_PT_*).
+ * @param uint64_t *size - Set to the size of the page.
+ * @return 0 if vaddr is mapped.
+ * */
+int pt_lookup(struct ARC_PTWalk *walk, uint64_t root, uint64_t vaddr, uint64_t *paddr, uint64_t *flags, uint64_t *size);
+
+#endif
@@ -30,16 +30,106 @@
 
 #include <global.h>
 
+#ifndef ARC_RECURSIVE_SLOT
+/// PML4 slot which maps the PML4 onto itself (-1: none).
+#define ARC_RECURSIVE_SLOT 510
+#endif
+
+/// Non-zero if map_range and promote_pages may use 2 MiB pages.
+extern int vmm_large_pages;
+/// Number of paging levels, 5 if LA57 is enabled. pml4 is the PML5 then.
+extern int vmm_levels;
+
+/// The page is writable.
+#define ARC_VMM_WRITE (1 << 1)
+/// The page is write-back cacheable (PA0).
+#define ARC_VMM_WB 0
+/// The page is write-combining (PA1, see arch/x86/pat.h).
+#define ARC_VMM_WC (1 << 3)
+/// The page is uncacheable (PA3).
+#define ARC_VMM_UC ((1 << 3) | (1 << 4))
+
 /**
  * Map the given page to the given page frame in the given PML4.
  *
  * New page tables will be created automatically, if overwrite is set to
  * 1 then any existing page is already mapped and present it will be
- * overwritten.
+ * overwritten. flags is any combination of the ARC_VMM_* flags, the
+ * page is always marked present.
  *
  * @return Returns a pointer to the PML4, upon success it will be the same
  * as uint64_t *pml4.
  * */
-uint64_t *map_page(uint64_t *pml4, uint64_t vaddr, uint64_t paddr, int overwrite);
+uint64_t *map_page(uint64_t *pml4, uint64_t vaddr, uint64_t paddr, uint64_t flags, int overwrite);
+
+/**
+ * Map the given 2 MiB page to the given 2 MiB page frame in the given PML4.
+ *
+ * Both addresses are rounded down to a 2 MiB boundary. An existing
+ * PML1 table is never overwritten, even if overwrite is set to 1.
+ *
+ * @return Returns a pointer to the PML4, upon success it will be the same
+ * as uint64_t *pml4.
+ * */
+uint64_t *map_large_page(uint64_t *pml4, uint64_t vaddr, uint64_t paddr, uint64_t flags, int overwrite);
+
+/**
+ * Map size bytes at vaddr to paddr in the given PML4.
+ *
+ * 2 MiB pages are used wherever vaddr and paddr are both 2 MiB aligned,
+ * 4 KiB pages are used for everything else.
+ *
+ * @return Returns a pointer to the PML4, upon success it will be the same
+ * as uint64_t *pml4.
+ * */
+uint64_t *map_range(uint64_t *pml4, uint64_t vaddr, uint64_t paddr, uint64_t size, uint64_t flags, int overwrite);
+
+/**
+ * Estimate the page tables needed to map a range.
+ *
+ * Counts every PML3, PML2 and PML1 table the range touches, tables
+ * shared with other ranges are counted again, so the result is an
+ * upper bound.
+ *
+ * @param uint64_t vaddr - Virtual base of the range.
+ * @param uint64_t size - Size of the range in bytes.
+ * @param int large - Non-zero if the range is mapped with map_range.
+ * @return The number of tables.
+ * */
+int count_tables(uint64_t vaddr, uint64_t size, int large);
+
+/**
+ * Translate a virtual address through the given PML4.
+ *
+ * @param uint64_t *pml4 - The PML4 to walk.
+ * @param uint64_t vaddr - The virtual address to translate.
+ * @param uint64_t *paddr - Set to the physical address vaddr maps to.
+ * @return 0 if vaddr is mapped, -1 if it is not.
+ * */
+int translate(uint64_t *pml4, uint64_t vaddr, uint64_t *paddr);
+
+/**
+ * Promote runs of 4 KiB pages to 2 MiB pages.
+ *
+ * Every PML1 table which maps a physically contiguous, 2 MiB
+ * aligned run of 512 pages with identical flags is replaced by a
+ * single 2 MiB page, and freed with free_table.
+ *
+ * @param uint64_t *pml4 - The PML4 to walk.
+ * @return The number of PML1 tables freed, each saves 511 TLB entries.
+ * */
+int promote_pages(uint64_t *pml4);
+
+/**
+ * Point the given PML4 slot at the PML4 itself.
+ *
+ * Must be the last change made to the PML4, as any later walk
+ * through the slot would treat the PML4 as a lower level table.
+ *
+ * @param uint64_t *pml4 - The PML4 to install the slot into.
+ * @param int slot - Slot to use, must be an unused higher half slot.
+ * @return Error code (0: success).
+ * */
+int install_recursive_slot(uint64_t *pml4, int slot);
 
 #endif
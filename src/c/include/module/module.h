@@ -0,0 +1,58 @@
+/**
+ * @file module.h
+ *
+ * @author awewsomegamer <awewsomegamer@gmail.com>
+ *
+ * @LICENSE
+ * Arctan-MB2BSP - Multiboot2 Bootstrapper for Arctan Kernel
+ * Copyright (C) 2023-2024 awewsomegamer
+ *
+ * This file is part of Arctan-MB2BSP
+ *
+ * Arctan is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; version 2
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * @DESCRIPTION
+ * Table of the modules handed over to the kernel.
+*/
+#ifndef ARC_MODULE_MODULE_H
+#define ARC_MODULE_MODULE_H
+
+#include <global.h>
+
+/// Most modules which can be handed over.
+#define ARC_MODULE_MAX 64
+
+/**
+ * Record a module given by the bootloader.
+ *
+ * @param char *cmdline - Command line of the module.
+ * @param uint64_t paddr - Physical base of the module.
+ * @param uint64_t size - Size of the module in bytes.
+ * @param int type - What the module is used for (ARC_MODULE_*).
+ * */
+void module_add(char *cmdline, uint64_t paddr, uint64_t size, int type);
+
+/**
+ * Create the module table in _boot_meta.modules.
+ *
+ * Every recorded module which is still in memory is listed, along
+ * with a hash index of their command lines. A module which is not
+ * page aligned is copied to page aligned memory first, so the kernel
+ * can map any of them in place. Must be called after load_kernel.
+ *
+ * @return Error code (0: success).
+ * */
+int create_module_table();
+
+#endif
@@ -0,0 +1,49 @@
+/**
+ * @file pvh.h
+ *
+ * @author awewsomegamer <awewsomegamer@gmail.com>
+ *
+ * @LICENSE
+ * Arctan-MB2BSP - Multiboot2 Bootstrapper for Arctan Kernel
+ * Copyright (C) 2023-2024 awewsomegamer
+ *
+ * This file is part of Arctan-MB2BSP
+ *
+ * Arctan is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; version 2
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * @DESCRIPTION
+ * Provides a function for reading the PVH start information
+ * structure.
+*/
+#ifndef ARC_PVH_PVH_H
+#define ARC_PVH_PVH_H
+
+#include <pvh/start_info.h>
+
+/**
+ * Reads the start information provided by a PVH loader.
+ *
+ * Populates the _boot_meta, also initializes the PMM, the same
+ * way read_mb2i does. Modules are told apart by their command
+ * lines like multiboot2 modules, unnamed modules are recognized
+ * by their contents (an ELF is the kernel, ARC_SNAPSHOT_MAGIC a
+ * snapshot, anything else is the initramfs), so QEMU's single
+ * -initrd module works.
+ *
+ * @param struct hvm_start_info *info - Pointer to the start information.
+ * @return Error code (0: success).
+ * */
+int read_pvh(struct hvm_start_info *info);
+
+#endif
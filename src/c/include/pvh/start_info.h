@@ -0,0 +1,74 @@
+/**
+ * @file start_info.h
+ *
+ * @author awewsomegamer <awewsomegamer@gmail.com>
+ *
+ * @LICENSE
+ * Arctan-MB2BSP - Multiboot2 Bootstrapper for Arctan Kernel
+ * Copyright (C) 2023-2024 awewsomegamer
+ *
+ * This file is part of Arctan-MB2BSP
+ *
+ * Arctan is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; version 2
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * @DESCRIPTION
+ * Definitions of the PVH (Xen HVM direct boot) start information.
+*/
+#ifndef ARC_PVH_START_INFO_H
+#define ARC_PVH_START_INFO_H
+
+#include <stdint.h>
+
+/// ELF note type holding the 32-bit physical entry point.
+#define XEN_ELFNOTE_PHYS32_ENTRY 18
+/// Value of hvm_start_info.magic, also passed as the signature to helper.
+#define XEN_HVM_START_MAGIC_VALUE 0x336EC578
+
+struct hvm_start_info {
+	/// XEN_HVM_START_MAGIC_VALUE.
+	uint32_t magic;
+	/// Version of the structure, memmap_* are only present from 1.
+	uint32_t version;
+	uint32_t flags;
+	/// Number of entries at modlist_paddr.
+	uint32_t nr_modules;
+	/// Physical address of struct hvm_modlist_entry[nr_modules].
+	uint64_t modlist_paddr;
+	/// Physical address of the NUL terminated command line.
+	uint64_t cmdline_paddr;
+	/// Physical address of the RSDP.
+	uint64_t rsdp_paddr;
+	/// Physical address of struct hvm_memmap_table_entry[memmap_entries].
+	uint64_t memmap_paddr;
+	uint32_t memmap_entries;
+	uint32_t reserved;
+}__attribute__((packed));
+
+struct hvm_modlist_entry {
+	uint64_t paddr;
+	uint64_t size;
+	/// Physical address of the module's command line (0: none).
+	uint64_t cmdline_paddr;
+	uint64_t reserved;
+}__attribute__((packed));
+
+struct hvm_memmap_table_entry {
+	uint64_t addr;
+	uint64_t size;
+	/// E820 type, the same as MULTIBOOT_MEMORY_*.
+	uint32_t type;
+	uint32_t reserved;
+}__attribute__((packed));
+
+#endif
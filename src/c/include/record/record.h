@@ -0,0 +1,96 @@
+/**
+ * @file record.h
+ *
+ * @author awewsomegamer <awewsomegamer@gmail.com>
+ *
+ * @LICENSE
+ * Arctan-MB2BSP - Multiboot2 Bootstrapper for Arctan Kernel
+ * Copyright (C) 2023-2024 awewsomegamer
+ *
+ * This file is part of Arctan-MB2BSP
+ *
+ * Arctan is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; version 2
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * @DESCRIPTION
+ * Boot record of the last boot attempts, kept in a fixed page across
+ * resets.
+*/
+#ifndef ARC_RECORD_RECORD_H
+#define ARC_RECORD_RECORD_H
+
+#include <global.h>
+
+#ifndef ARC_BOOT_RECORD_PADDR
+/// Physical address of the boot record page (0: no boot record).
+#define ARC_BOOT_RECORD_PADDR 0x1000
+#endif
+
+/// The boot record, NULL if there is none.
+extern struct ARC_BootRecord *boot_record;
+
+/**
+ * Look at the boot record, without writing to it.
+ *
+ * Checks the magic and checksum of the record at ARC_BOOT_RECORD_PADDR
+ * and notes the time the boot attempt started. Nothing is written
+ * until the page is known to be free, see reserve_boot_record.
+ * */
+void open_boot_record();
+
+/**
+ * Note memory the loader handed over.
+ *
+ * The boot record is dropped by reserve_boot_record if any of it
+ * lies in the record's page.
+ *
+ * @param uint64_t base - Base of the memory.
+ * @param uint64_t len - Length of the memory in bytes.
+ * */
+void boot_record_avoid(uint64_t base, uint64_t len);
+
+/**
+ * Start a new boot attempt in the boot record.
+ *
+ * The record is reset if open_boot_record found it corrupt,
+ * otherwise the attempts in it are kept. The oldest slot is taken
+ * for the new attempt, and crash_record is pointed at it, so that
+ * exceptions end up in the record. Called by reserve_boot_record,
+ * or directly once the page has been reserved by an earlier boot.
+ *
+ * Must be called before init_idt64.
+ * */
+void claim_boot_record();
+
+/**
+ * Reserve the boot record's page in the memory map.
+ *
+ * The available entry holding the page is split, so that the page
+ * gets an entry of type ARC_MEMORY_BOOT_RECORD, and the record is
+ * claimed. If the page is not available memory, or holds something
+ * passed to boot_record_avoid, the boot record is dropped untouched.
+ *
+ * @param struct ARC_MMap *mmap - Memory map, ARC_PMM_MAX_MMAP entries long.
+ * @param int entries - Number of entries used.
+ * @return The new number of entries.
+ * */
+int reserve_boot_record(struct ARC_MMap *mmap, int entries);
+
+/**
+ * Record that the given phase of the boot was reached.
+ *
+ * @param int phase - ARC_PHASE_*.
+ * */
+void boot_phase(int phase);
+
+#endif
@@ -0,0 +1,53 @@
+/**
+ * @file snapshot.h
+ *
+ * @author awewsomegamer <awewsomegamer@gmail.com>
+ *
+ * @LICENSE
+ * Arctan-MB2BSP - Multiboot2 Bootstrapper for Arctan Kernel
+ * Copyright (C) 2023-2024 awewsomegamer
+ *
+ * This file is part of Arctan-MB2BSP
+ *
+ * Arctan is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; version 2
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * @DESCRIPTION
+ * Resuming a kernel from a memory snapshot module.
+*/
+#ifndef ARC_SNAPSHOT_SNAPSHOT_H
+#define ARC_SNAPSHOT_SNAPSHOT_H
+
+#include <global.h>
+
+/// Context _kernel_station resumes instead of entering the kernel (NULL: none).
+extern struct ARC_SnapshotContext *resume_context;
+
+/**
+ * Restore the snapshot module in _boot_meta.snapshot.
+ *
+ * Every extent is checked before anything is written, so a
+ * snapshot which cannot be restored leaves memory untouched and
+ * the boot can carry on as usual. On success, pml4, vmm_levels
+ * and resume_context are set up for the saved context to be
+ * resumed once long mode is enabled.
+ *
+ * Extents must lie within available memory in _boot_meta.arc_mmap,
+ * and must not overlap the bootstrapper, the module itself or the
+ * boot record.
+ *
+ * @return Error code (0: success).
+ * */
+int restore_snapshot();
+
+#endif
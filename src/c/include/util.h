@@ -53,7 +53,31 @@
 #endif // ARC_DEBUG_ENABLE
 
 int strcmp(char *a, char *b);
+/**
+ * Check whether the NUL terminated strings a and b are identical.
+ *
+ * @return non-zero if they are equal.
+ * */
+int names_equal(char *a, char *b);
+/**
+ * Hash the NUL terminated string name.
+ *
+ * The kernel looks modules up with the same hash.
+ *
+ * @return 32-bit FNV-1a hash.
+ * */
+uint32_t name_hash(char *name);
 int memcpy(void *a, void *b, size_t size);
 void memset(void *mem, uint8_t value, size_t size);
+/**
+ * Copy size bytes from b to a using the fastest method the CPU supports.
+ * */
+void fast_memcpy(void *a, void *b, size_t size);
+/**
+ * Fill size bytes at mem with value using the fastest method the CPU supports.
+ *
+ * Large fills use non-temporal stores, so they do not evict the cache.
+ * */
+void fast_memset(void *mem, uint8_t value, size_t size);
 
 #endif
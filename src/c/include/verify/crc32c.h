@@ -0,0 +1,46 @@
+/**
+ * @file crc32c.h
+ *
+ * @author awewsomegamer <awewsomegamer@gmail.com>
+ *
+ * @LICENSE
+ * Arctan-MB2BSP - Multiboot2 Bootstrapper for Arctan Kernel
+ * Copyright (C) 2023-2024 awewsomegamer
+ *
+ * This file is part of Arctan-MB2BSP
+ *
+ * Arctan is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; version 2
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * @DESCRIPTION
+ * CRC32C (Castagnoli) checksums.
+*/
+#ifndef ARC_VERIFY_CRC32C_H
+#define ARC_VERIFY_CRC32C_H
+
+#include <global.h>
+
+/**
+ * Compute the CRC32C of data.
+ *
+ * Uses the crc32 instruction on three streams at once if the CPU
+ * has SSE4.2, slicing-by-8 tables otherwise.
+ *
+ * @param uint32_t crc - CRC of the preceding data, 0 to start.
+ * @param void *data - Data to checksum.
+ * @param size_t size - Size of data in bytes.
+ * @return The CRC32C of the preceding data and data.
+ * */
+uint32_t crc32c(uint32_t crc, void *data, size_t size);
+
+#endif
@@ -0,0 +1,53 @@
+/**
+ * @file verify.h
+ *
+ * @author awewsomegamer <awewsomegamer@gmail.com>
+ *
+ * @LICENSE
+ * Arctan-MB2BSP - Multiboot2 Bootstrapper for Arctan Kernel
+ * Copyright (C) 2023-2024 awewsomegamer
+ *
+ * This file is part of Arctan-MB2BSP
+ *
+ * Arctan is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; version 2
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * @DESCRIPTION
+ * Integrity checks of the kernel and initramfs modules.
+*/
+#ifndef ARC_VERIFY_VERIFY_H
+#define ARC_VERIFY_VERIFY_H
+
+#include <global.h>
+
+/**
+ * Read the expected CRC32Cs from the bootstrapper's command line.
+ *
+ * Recognises "crc32c.kernel=<hex>" and "crc32c.initramfs=<hex>",
+ * separated by spaces.
+ *
+ * @param char *cmdline - Command line to read.
+ * */
+void read_crc32c_args(char *cmdline);
+
+/**
+ * Check the kernel and initramfs modules.
+ *
+ * Every module an expected CRC32C was given for is checked, the
+ * results and time taken are recorded in _boot_meta.
+ *
+ * @return 0 unless the kernel module does not match.
+ * */
+int verify_modules();
+
+#endif
@@ -0,0 +1,121 @@
+/**
+ * @file warm.h
+ *
+ * @author awewsomegamer <awewsomegamer@gmail.com>
+ *
+ * @LICENSE
+ * Arctan-MB2BSP - Multiboot2 Bootstrapper for Arctan Kernel
+ * Copyright (C) 2023-2024 awewsomegamer
+ *
+ * This file is part of Arctan-MB2BSP
+ *
+ * Arctan is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; version 2
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * @DESCRIPTION
+ * Warm reboots, which load a new kernel into the address space
+ * built by the previous boot.
+*/
+#ifndef ARC_WARM_WARM_H
+#define ARC_WARM_WARM_H
+
+#include <global.h>
+
+/// "WARM"
+#define ARC_WARM_MAGIC 0x4D524157
+
+#ifndef ARC_WARM_MAX_TABLES
+/// Most page tables the identity map and HHDM may consist of for a warm reboot.
+#define ARC_WARM_MAX_TABLES 1024
+#endif
+
+struct ARC_WarmDesc {
+	uint32_t magic;
+	/// Bytes of the descriptor sum to zero.
+	uint8_t checksum;
+	uint8_t reserved[3];
+	/// Physical address of _boot_meta.
+	uint64_t boot_meta;
+	/// Physical address and bounds of the PMM's freelist.
+	uint64_t pmm_state;
+	uint64_t pmm_base;
+	uint64_t pmm_ciel;
+	/// Physical address of the root page table.
+	uint64_t pml4;
+	/// Number of paging levels.
+	uint32_t levels;
+	/// Root slots which map the HHDM.
+	uint32_t hhdm_first_slot;
+	uint32_t hhdm_last_slot;
+	/// Sum of the root entries which map the HHDM.
+	uint32_t hhdm_sum;
+	uint64_t hhdm_vaddr;
+}__attribute__((packed));
+
+/// Arguments the kernel passes to _boot_meta.warm_entry in RDI, RSI and RDX.
+struct ARC_WarmArgs {
+	/// Physical address of the new kernel ELF, below 4 GiB.
+	uint64_t kernel_elf;
+	/// Size of the new kernel ELF.
+	uint64_t kernel_elf_size;
+	/// Passed to the new kernel in _boot_meta.state.
+	uint64_t state;
+}__attribute__((packed));
+
+/**
+ * Describe the finished address space for a later warm reboot.
+ *
+ * Fills in the descriptor, _boot_meta.warm_entry and
+ * _boot_meta.warm_desc. Must be the last thing done before the
+ * kernel is entered.
+ *
+ * @return Error code (0: success).
+ * */
+int create_warm_desc();
+
+/**
+ * Check that the address space described by create_warm_desc
+ * survived the previous kernel.
+ *
+ * @return Error code (0: the descriptor and what it describes are intact).
+ * */
+int check_warm_desc();
+
+/**
+ * Forget everything the previous kernel was given.
+ *
+ * Unmaps every root slot except the identity map and the HHDM,
+ * whose tables are reused as they are, and clears the handoff
+ * fields which describe the kernel. The memory behind them is
+ * reclaimed by rebuild_pmm.
+ * */
+void reset_kernel_state();
+
+/**
+ * Rebuild the PMM's freelist after a warm reboot.
+ *
+ * The freelist's nodes lived in memory the previous kernel owned,
+ * so it is built again from _boot_meta.arc_mmap within the bounds
+ * kept in the descriptor. Every frame is free except the tables
+ * still reachable from the root (call after reset_kernel_state),
+ * the new kernel ELF, and the memory map, HHDM ranges, lazy HHDM
+ * list and APIC map, which are handed to the new kernel as they are.
+ * The page table arena and HHDM pool are freed along with the rest
+ * and must be made again.
+ *
+ * @param struct ARC_WarmArgs *args - Arguments passed to the warm entry.
+ * @return Error code (0: success).
+ * */
+int rebuild_pmm(struct ARC_WarmArgs *args);
+
+#endif
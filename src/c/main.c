@@ -36,35 +36,220 @@
 #include <multiboot/mbparse.h>
 #include <mm/freelist.h>
 #include <mm/vmm.h>
+#include <mm/hhdm.h>
+#include <mm/early.h>
+#include <mm/pmm.h>
+#include <mm/ptarena.h>
 #include <multiboot/multiboot2.h>
+#include <pvh/pvh.h>
 #include <arch/x86/cpuid.h>
+#include <arch/x86/tss.h>
+#include <arch/x86/apic.h>
+#include <arch/x86/idt64.h>
+#include <record/record.h>
 #include <elf/elf.h>
+#include <acpi/acpi.h>
+#include <warm/warm.h>
+#include <snapshot/snapshot.h>
+#include <elf/plan.h>
+#include <elf/tls.h>
+#include <elf/driver.h>
+#include <mm/inspect.h>
+#include <verify/verify.h>
+#include <module/module.h>
 
 struct ARC_FreelistMeta physical_mem = { 0 };
 uint64_t *pml4 = NULL;
 uint64_t kernel_entry = 0;
+uint64_t kernel_stack = 0;
+uint64_t kernel_fs_base = 0;
+
+// Honour the kernel's ELF notes which shape the address space
+static void apply_kernel_notes() {
+	if (read_elf_notes((void *)((uint32_t)_boot_meta.kernel_elf)) != 0) {
+		return;
+	}
+
+	uint32_t missing = kernel_notes.features & ~cpu_features;
+
+	if (missing != 0) {
+		printf("Kernel requires unsupported CPU features (0x%x), stopping.\n", missing);
+		ARC_HANG
+	}
+
+	if ((kernel_notes.present & (1 << ARC_NOTE_PAGE_SIZES)) && (kernel_notes.page_sizes & ARC_NOTE_PAGE_2M) == 0) {
+		vmm_large_pages = 0;
+	}
+
+	if (kernel_notes.paging_levels == 5 && (cpu_features & ARC_CPU_FEATURE_LA57) && pml4 == NULL) {
+		// boot.asm sets CR4.LA57 before enabling paging
+		vmm_levels = 5;
+	}
+
+	if (kernel_notes.present & (1 << ARC_NOTE_HHDM_BASE)) {
+		uint64_t base = kernel_notes.hhdm_base;
+		// Lowest canonical higher half address
+		uint64_t lowest = vmm_levels == 5 ? 0xFF00000000000000 : 0xFFFF800000000000;
+
+		if (_boot_meta.hhdm_vaddr != 0 && base != _boot_meta.hhdm_vaddr) {
+			ARC_DEBUG(WARN, "The HHDM cannot be moved after it is built\n");
+		} else if (base >= lowest && (base & 0x1FFFFF) == 0) {
+			_boot_meta.hhdm_vaddr = base;
+		} else {
+			ARC_DEBUG(WARN, "Ignoring invalid HHDM base 0x%"PRIx64"\n", base);
+		}
+	}
+}
+
+// Map the kernel and everything built for it
+static void load_kernel() {
+	void *kernel = (void *)((uint32_t)_boot_meta.kernel_elf);
+
+	// Map kernel, from the boot plan if one was made for it
+	kernel_entry = load_plan(pml4, kernel);
+
+	if (kernel_entry != 0) {
+		finish_elf(pml4, kernel);
+	} else {
+		kernel_entry = load_elf(pml4, kernel);
+	}
+
+	// Before the module may be released, the template is read from it
+	if (kernel_entry > 1 && create_tls_blocks(kernel) != 0) {
+		ARC_DEBUG(WARN, "TLS blocks are unavailable\n")
+	}
+
+	kernel_fs_base = tls_pointer(0);
+
+	if (kernel_entry > 1 && load_drivers() != 0) {
+		ARC_DEBUG(WARN, "Some drivers could not be loaded\n")
+	}
+
+	if ((ARC_ELF_RELOCATE || _boot_meta.boot_plan_used) && kernel_entry > 1) {
+		// The kernel has been copied out of its module
+		if (pmm_release(_boot_meta.kernel_elf, _boot_meta.kernel_elf_size) == 0) {
+			_boot_meta.kernel_elf = 0;
+			_boot_meta.kernel_elf_size = 0;
+		}
+	}
+
+	if (map_early_regions() != 0) {
+		ARC_DEBUG(WARN, "Early kernel heap, per-CPU areas or kernel stack are unavailable\n")
+	}
+
+	kernel_stack = _boot_meta.kernel_stack;
+
+	if (create_cpu_descs() != 0) {
+		ARC_DEBUG(WARN, "Per-CPU GDTs, TSSs and stacks are unavailable\n")
+	}
+}
+
+// Finish the address space once nothing else will be allocated
+static void finish_address_space() {
+	if (finalize_hhdm() != 0) {
+		ARC_DEBUG(ERR, "Failed to finalize HHDM\n")
+		ARC_HANG
+	}
+
+	_boot_meta.pt_promoted = promote_pages(pml4);
+	_boot_meta.pt_tlb_saved = _boot_meta.pt_promoted * 511;
+
+	_boot_meta.pt_recursive_slot = -1;
+
+	if (ARC_RECURSIVE_SLOT >= 0 && install_recursive_slot(pml4, ARC_RECURSIVE_SLOT) == 0) {
+		_boot_meta.pt_recursive_slot = ARC_RECURSIVE_SLOT;
+	}
+
+	_boot_meta.pmm_state = (uintptr_t)&physical_mem;
+	_boot_meta.pt_levels = vmm_levels;
+
+	create_warm_desc();
+}
 
 int helper(void *mbi, uint32_t signature) {
+	open_boot_record();
+
 	ARC_DEBUG(INFO, "Loaded\n");
         *((uint8_t *)0xB8000) = 'C';
 
-	if (signature != MULTIBOOT2_BOOTLOADER_MAGIC) {
-		printf("System was not booted using a multiboot2 bootloader, stopping.\n");
+	if (signature == MULTIBOOT2_BOOTLOADER_MAGIC) {
+		_boot_meta.boot_proc = ARC_BOOTPROC_MB2;
+	} else if (signature == XEN_HVM_START_MAGIC_VALUE) {
+		_boot_meta.boot_proc = ARC_BOOTPROC_PVH;
+	} else {
+		printf("System was not booted using a multiboot2 bootloader or PVH, stopping.\n");
 		ARC_HANG
 	}
 
-	_boot_meta.boot_proc = ARC_BOOTPROC_MB2;
-
 	check_features();
+	_boot_meta.cpu_features = cpu_features;
 
 	install_gdt();
 	install_idt();
 
-	read_mb2i(mbi);
+	init_apic();
+
+	int err = 0;
+
+	if (_boot_meta.boot_proc == ARC_BOOTPROC_PVH) {
+		err = read_pvh((struct hvm_start_info *)mbi);
+	} else {
+		err = read_mb2i(mbi);
+	}
+
+	if (err != 0 || (_boot_meta.kernel_elf == 0 && _boot_meta.snapshot == 0)) {
+		printf("Failed to read boot information or no kernel was found, stopping.\n");
+		ARC_HANG
+	}
+
+	// After the memory map, which may drop the boot record
+	init_idt64();
+	boot_phase(ARC_PHASE_BOOT_INFO);
+
+	if (verify_modules() != 0) {
+		printf("Kernel module is corrupt, stopping.\n");
+		ARC_HANG
+	}
+
+	if (_boot_meta.snapshot != 0) {
+		if (restore_snapshot() == 0) {
+			// Long mode is enabled with the snapshot's page tables
+			// and _kernel_station resumes it
+			boot_phase(ARC_PHASE_HANDOFF);
+			return 0;
+		}
+
+		if (_boot_meta.kernel_elf == 0) {
+			printf("Failed to restore snapshot and no kernel was found, stopping.\n");
+			ARC_HANG
+		}
+
+		ARC_DEBUG(WARN, "Failed to restore snapshot, booting the kernel\n")
+	}
+
+	read_acpi();
+	boot_phase(ARC_PHASE_ACPI);
+
+	apply_kernel_notes();
+
+	if (create_table_arena() != 0) {
+		ARC_DEBUG(WARN, "Allocating page tables from the PMM\n")
+	}
+
+	if (create_hhdm() != 0) {
+		ARC_DEBUG(ERR, "Failed to create HHDM\n")
+		ARC_HANG
+	}
+
+	boot_phase(ARC_PHASE_HHDM);
+
+	if (create_apic_map() != 0) {
+		ARC_DEBUG(WARN, "APIC map is unavailable\n")
+	}
 
 	// Identity map first 4MB
 	for (int i = 0; i < 4 * 512; i++) {
-		pml4 = map_page(pml4, i << 12, i << 12, 1);
+		pml4 = map_page(pml4, i << 12, i << 12, ARC_VMM_WRITE, 1);
 
 		if (pml4 == NULL) {
 			ARC_DEBUG(ERR, "Mapping failed\n")
@@ -72,13 +257,78 @@ int helper(void *mbi, uint32_t signature) {
 		}
 	}
 
-	// Map kernel
-	kernel_entry = load_elf(pml4, (void *)((uint32_t)_boot_meta.kernel_elf));
+	load_kernel();
+	boot_phase(ARC_PHASE_KERNEL);
 
-	_boot_meta.pmm_state = (uintptr_t)&physical_mem;
+	// Before the HHDM is finalized, so the table and any copied
+	// modules are mapped
+	if (create_module_table() != 0) {
+		ARC_DEBUG(WARN, "Some modules could not be handed over\n")
+	}
+
+	finish_address_space();
+
+#ifdef ARC_DEBUG_ENABLE
+	inspect_tables(pml4);
+#endif
 
         ARC_DEBUG(INFO, "Done with bootstrapping, enabling paging and long mode, jumping to 0x%"PRIx64"\n", kernel_entry);
         *((uint8_t *)0xB8002) = 'D';
 
+	boot_phase(ARC_PHASE_HANDOFF);
+
+	return 0;
+}
+
+int warm_helper(struct ARC_WarmArgs *args) {
+	if (_boot_meta.boot_record != 0) {
+		// The page was reserved by the cold boot
+		open_boot_record();
+		claim_boot_record();
+	}
+
+	ARC_DEBUG(INFO, "Warm reboot\n");
+
+	install_gdt();
+	install_idt();
+	init_idt64();
+	boot_phase(ARC_PHASE_BOOT_INFO);
+
+	if (check_warm_desc() != 0) {
+		printf("Cannot warm reboot, stopping.\n");
+		ARC_HANG
+	}
+
+	_boot_meta.kernel_elf = args->kernel_elf;
+	_boot_meta.kernel_elf_size = args->kernel_elf_size;
+	_boot_meta.state = args->state;
+
+	// The identity map and HHDM are reused as they are
+	reset_kernel_state();
+
+	if (rebuild_pmm(args) != 0) {
+		printf("Cannot reclaim memory for a warm reboot, stopping.\n");
+		ARC_HANG
+	}
+
+	apply_kernel_notes();
+
+	if (create_table_arena() != 0) {
+		ARC_DEBUG(WARN, "Allocating page tables from the PMM\n")
+	}
+
+	if (renew_hhdm_pool() != 0) {
+		ARC_DEBUG(ERR, "Failed to renew HHDM page table pool\n")
+		ARC_HANG
+	}
+
+	load_kernel();
+	finish_address_space();
+	boot_phase(ARC_PHASE_KERNEL);
+
+	ARC_DEBUG(INFO, "Done with warm reboot, jumping to 0x%"PRIx64"\n", kernel_entry);
+
+	boot_phase(ARC_PHASE_HANDOFF);
+
 	return 0;
 }
@@ -0,0 +1,143 @@
+/**
+ * @file early.c
+ *
+ * @author awewsomegamer <awewsomegamer@gmail.com>
+ *
+ * @LICENSE
+ * Arctan-MB2BSP - Multiboot2 Bootstrapper for Arctan Kernel
+ * Copyright (C) 2023-2024 awewsomegamer
+ *
+ * This file is part of Arctan-MB2BSP
+ *
+ * Arctan is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; version 2
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * @DESCRIPTION
+ * Pre-mapped early kernel heap and per-CPU areas.
+*/
+#include <mm/early.h>
+#include <mm/vmm.h>
+#include <mm/freelist.h>
+#include <elf/elf.h>
+#include <global.h>
+
+// Allocate size bytes of 2 MiB aligned memory and map it at vaddr
+// Return: physical base, 0 on failure
+static uint64_t map_early_region(uint64_t vaddr, uint64_t size) {
+	void *base = Arc_ListContiguousAlignedAlloc(&physical_mem, size / 0x1000, 0x200000);
+
+	if (base == NULL) {
+		ARC_DEBUG(ERR, "Failed to allocate 0x%"PRIx64" B for 0x%"PRIx64"\n", size, vaddr);
+		return 0;
+	}
+
+	pml4 = map_range(pml4, vaddr, (uintptr_t)base, size, ARC_VMM_WRITE | ARC_VMM_WB, 0);
+
+	if (pml4 == NULL) {
+		ARC_DEBUG(ERR, "Failed to map 0x%"PRIx64"\n", vaddr);
+		ARC_HANG
+	}
+
+	ARC_DEBUG(INFO, "Mapped 0x%"PRIx64" B at 0x%"PRIx64" -> 0x%"PRIxPTR"\n", size, vaddr, (uintptr_t)base);
+
+	return (uintptr_t)base;
+}
+
+// Map a stack of size bytes above a guard page
+// Return 0: success
+static int map_kernel_stack(uint64_t size) {
+	void *base = Arc_ListContiguousAlignedAlloc(&physical_mem, size / 0x1000, 0x1000);
+
+	if (base == NULL) {
+		ARC_DEBUG(ERR, "Failed to allocate 0x%"PRIx64" B for the kernel stack\n", size);
+		return -1;
+	}
+
+	// The page at ARC_KERNEL_STACK_VADDR is left unmapped
+	uint64_t vaddr = ARC_KERNEL_STACK_VADDR + 0x1000;
+
+	pml4 = map_range(pml4, vaddr, (uintptr_t)base, size, ARC_VMM_WRITE | ARC_VMM_WB, 0);
+
+	if (pml4 == NULL) {
+		ARC_DEBUG(ERR, "Failed to map 0x%"PRIx64"\n", vaddr);
+		ARC_HANG
+	}
+
+	_boot_meta.kernel_stack = vaddr + size;
+	_boot_meta.kernel_stack_size = size;
+
+	ARC_DEBUG(INFO, "Mapped 0x%"PRIx64" B kernel stack below 0x%"PRIx64"\n", size, _boot_meta.kernel_stack);
+
+	return 0;
+}
+
+// Return: size of the early heap in bytes
+static uint64_t early_heap_size() {
+	uint64_t heap_size = ARC_EARLY_HEAP_SIZE;
+
+	if (kernel_notes.present & (1 << ARC_NOTE_EARLY_HEAP)) {
+		heap_size = kernel_notes.early_heap_size;
+	}
+
+	return ALIGN(heap_size, 0x200000);
+}
+
+int early_count_tables() {
+	int cpus = max(_boot_meta.cpu_count, 1);
+	int count = count_tables(ARC_EARLY_HEAP_VADDR, early_heap_size(), 1);
+
+	count += count_tables(ARC_PERCPU_VADDR, ALIGN(cpus * ALIGN((uint64_t)ARC_PERCPU_SIZE, 0x1000), 0x200000), 1);
+	count += count_tables(ARC_KERNEL_STACK_VADDR, ALIGN(kernel_notes.stack_size, 0x1000) + 0x1000, 1);
+
+	return count;
+}
+
+int map_early_regions() {
+	int cpus = max(_boot_meta.cpu_count, 1);
+	uint64_t heap_size = early_heap_size();
+	uint64_t percpu_size = ALIGN((uint64_t)ARC_PERCPU_SIZE, 0x1000);
+	int err = 0;
+
+	if (heap_size != 0) {
+		_boot_meta.early_heap_paddr = map_early_region(ARC_EARLY_HEAP_VADDR, heap_size);
+
+		if (_boot_meta.early_heap_paddr != 0) {
+			_boot_meta.early_heap = ARC_EARLY_HEAP_VADDR;
+			_boot_meta.early_heap_size = heap_size;
+		}
+	}
+
+	if (percpu_size != 0) {
+		uint64_t size = ALIGN(cpus * percpu_size, 0x200000);
+
+		_boot_meta.percpu_paddr = map_early_region(ARC_PERCPU_VADDR, size);
+
+		if (_boot_meta.percpu_paddr != 0) {
+			// Per-CPU storage starts out zeroed, like .bss
+			fast_memset((void *)((uint32_t)_boot_meta.percpu_paddr), 0, size);
+
+			_boot_meta.percpu = ARC_PERCPU_VADDR;
+			_boot_meta.percpu_size = percpu_size;
+		}
+	}
+
+	if (kernel_notes.stack_size != 0) {
+		err = map_kernel_stack(ALIGN(kernel_notes.stack_size, 0x1000));
+	}
+
+	if (_boot_meta.early_heap_size != heap_size || _boot_meta.percpu_size != percpu_size) {
+		err = -1;
+	}
+
+	return err;
+}
@@ -38,6 +38,10 @@ void *Arc_ListAlloc(struct ARC_FreelistMeta *meta) {
 	void *address = (void *)meta->head;
 	meta->head = meta->head->next;
 
+	if (address > (void *)meta->highest) {
+		meta->highest = address;
+	}
+
 	return address;
 }
 
@@ -109,6 +113,58 @@ void *Arc_ListContiguousAlloc(struct ARC_FreelistMeta *meta, int objects) {
 	return min(base, allocation);
 }
 
+// Allocate objects contiguous objects, the first of which is aligned to align
+// Return: non-NULL = success
+void *Arc_ListContiguousAlignedAlloc(struct ARC_FreelistMeta *meta, int objects, uintptr_t align) {
+	// Node before the first node of the current run
+	struct ARC_FreelistNode *before = NULL;
+	// First node of the current run
+	struct ARC_FreelistNode *base = NULL;
+	// Node before the current node
+	struct ARC_FreelistNode *last = NULL;
+	struct ARC_FreelistNode *current = meta->head;
+	int object_count = 0;
+
+	while (current != NULL && object_count < objects) {
+		if (object_count > 0 && (uintptr_t)current == (uintptr_t)last + meta->object_size) {
+			// Extend the current run
+			object_count++;
+		} else if (((uintptr_t)current & (align - 1)) == 0) {
+			// Start a new run
+			before = last;
+			base = current;
+			object_count = 1;
+		} else {
+			object_count = 0;
+		}
+
+		if (object_count == objects) {
+			// Unlink the run from the list
+			if (before == NULL) {
+				meta->head = current->next;
+			} else {
+				before->next = current->next;
+			}
+
+			if (current > meta->highest) {
+				meta->highest = current;
+			}
+
+			return base;
+		}
+
+		if (current == meta->ciel) {
+			// The last node is never linked onwards
+			break;
+		}
+
+		last = current;
+		current = current->next;
+	}
+
+	return NULL;
+}
+
 // Free given address in given list
 // Return: non-NULL = success
 void *Arc_ListFree(struct ARC_FreelistMeta *meta, void *address) {
@@ -0,0 +1,317 @@
+/**
+ * @file hhdm.c
+ *
+ * @author awewsomegamer <awewsomegamer@gmail.com>
+ *
+ * @LICENSE
+ * Arctan-MB2BSP - Multiboot2 Bootstrapper for Arctan Kernel
+ * Copyright (C) 2023-2024 awewsomegamer
+ *
+ * This file is part of Arctan-MB2BSP
+ *
+ * Arctan is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; version 2
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * @DESCRIPTION
+ * Higher half direct map (HHDM) construction.
+*/
+#include <mm/hhdm.h>
+#include <mm/vmm.h>
+#include <mm/freelist.h>
+#include <mm/ptarena.h>
+#include <arch/x86/cpuid.h>
+#include <global.h>
+
+/// Everything below this physical address is mapped into the HHDM.
+static uint64_t hhdm_ceil = 0;
+/// MMIO windows to map into the HHDM.
+static struct ARC_HHDMRange mmio_windows[ARC_HHDM_MAX_MMIO] = { 0 };
+static int mmio_window_count = 0;
+
+int hhdm_add_mmio(uint64_t base, uint64_t len, int cache) {
+	if (mmio_window_count >= ARC_HHDM_MAX_MMIO) {
+		ARC_DEBUG(WARN, "Too many MMIO windows, not mapping 0x%"PRIx64"\n", base);
+		return -1;
+	}
+
+	struct ARC_HHDMRange *window = &mmio_windows[mmio_window_count++];
+
+	window->base = base & ~0xFFFULL;
+	window->len = ALIGN(base + len, 0x1000) - window->base;
+	window->cache = cache;
+	window->read_only = 0;
+
+	return 0;
+}
+
+// Describe how the given memory map entry is mapped into the HHDM
+static void describe_entry(struct ARC_MMap *entry, struct ARC_HHDMRange *range) {
+	range->base = entry->base;
+	range->len = entry->len;
+	range->cache = ARC_CACHE_WB;
+	range->read_only = 0;
+
+	switch (entry->type) {
+	case MULTIBOOT_MEMORY_AVAILABLE:
+	case MULTIBOOT_MEMORY_NVS:
+	case ARC_MEMORY_BOOT_DATA:
+		break;
+
+	case MULTIBOOT_MEMORY_ACPI_RECLAIMABLE:
+		// Tables are only read until the kernel reclaims them
+		range->read_only = 1;
+		break;
+
+	default:
+		// Reserved, bad and unknown memory is never mapped, any
+		// MMIO within it is mapped through mmio_windows
+		range->cache = ARC_CACHE_NONE;
+		break;
+	}
+}
+
+static uint64_t range_flags(struct ARC_HHDMRange *range) {
+	uint64_t flags = range->read_only ? 0 : ARC_VMM_WRITE;
+
+	switch (range->cache) {
+	case ARC_CACHE_WC:
+		// Without the PAT, PWT alone would select WT
+		return flags | ((cpu_features & ARC_CPU_FEATURE_PAT) ? ARC_VMM_WC : ARC_VMM_UC);
+	case ARC_CACHE_UC:
+		return flags | ARC_VMM_UC;
+	}
+
+	return flags | ARC_VMM_WB;
+}
+
+// Return: base of the HHDM, ARC_HHDM_BASE(_LA57) unless the kernel asked for another
+static uint64_t hhdm_base() {
+	if (_boot_meta.hhdm_vaddr == 0) {
+		_boot_meta.hhdm_vaddr = vmm_levels == 5 ? ARC_HHDM_BASE_LA57 : ARC_HHDM_BASE;
+	}
+
+	return _boot_meta.hhdm_vaddr;
+}
+
+int hhdm_count_tables() {
+	struct ARC_MMap *mmap = (struct ARC_MMap *)((uint32_t)_boot_meta.arc_mmap);
+	uint64_t left = ARC_HHDM_EAGER_SIZE;
+	int count = 0;
+
+	for (int i = 0; i < _boot_meta.arc_mmap_len; i++) {
+		struct ARC_HHDMRange range;
+		describe_entry(&mmap[i], &range);
+
+		if (range.cache == ARC_CACHE_NONE) {
+			continue;
+		}
+
+		if (ARC_HHDM_EAGER_SIZE != 0 && mmap[i].type == MULTIBOOT_MEMORY_AVAILABLE) {
+			range.len = min(range.len, left);
+			left -= range.len;
+		}
+
+		count += count_tables(range.base + hhdm_base(), range.len, 1);
+	}
+
+	for (int i = 0; i < mmio_window_count; i++) {
+		count += count_tables(mmio_windows[i].base + hhdm_base(), mmio_windows[i].len, 1);
+	}
+
+	if (ARC_HHDM_EAGER_SIZE != 0) {
+		count += ARC_HHDM_POOL_PAGES;
+	}
+
+	return count;
+}
+
+// Map all usable memory in [base, ceil) into the HHDM
+// Return 0: success
+static int hhdm_map_usable(uint64_t base, uint64_t ceil) {
+	struct ARC_MMap *mmap = (struct ARC_MMap *)((uint32_t)_boot_meta.arc_mmap);
+
+	for (int i = 0; i < _boot_meta.arc_mmap_len; i++) {
+		if (mmap[i].type != MULTIBOOT_MEMORY_AVAILABLE) {
+			continue;
+		}
+
+		uint64_t low = max(mmap[i].base, base);
+		uint64_t high = min(mmap[i].base + mmap[i].len, ceil);
+
+		if (low >= high) {
+			continue;
+		}
+
+		pml4 = map_range(pml4, low + ARC_HHDM_VADDR, low, high - low, ARC_VMM_WRITE | ARC_VMM_WB, 1);
+
+		if (pml4 == NULL) {
+			ARC_DEBUG(ERR, "Mapping failed\n");
+			return -1;
+		}
+	}
+
+	return 0;
+}
+
+int create_hhdm() {
+	struct ARC_MMap *mmap = (struct ARC_MMap *)((uint32_t)_boot_meta.arc_mmap);
+
+	uint64_t base = hhdm_base();
+	ARC_DEBUG(INFO, "Creating HHDM at 0x%"PRIx64"\n", base);
+
+	// Describe every range for the kernel, so it never maps
+	// anything with a conflicting memory type
+	int range_count = _boot_meta.arc_mmap_len + mmio_window_count;
+	int range_pages = ALIGN(range_count * sizeof(struct ARC_HHDMRange), 0x1000) / 0x1000;
+	struct ARC_HHDMRange *ranges = (struct ARC_HHDMRange *)Arc_ListContiguousAlloc(&physical_mem, range_pages);
+
+	if (ranges == NULL) {
+		ARC_DEBUG(ERR, "Failed to allocate HHDM range table\n");
+		return -1;
+	}
+
+	for (int i = 0; i < _boot_meta.arc_mmap_len; i++) {
+		describe_entry(&mmap[i], &ranges[i]);
+	}
+
+	fast_memcpy(&ranges[_boot_meta.arc_mmap_len], mmio_windows, mmio_window_count * sizeof(struct ARC_HHDMRange));
+
+	_boot_meta.hhdm_ranges = (uintptr_t)ranges;
+	_boot_meta.hhdm_ranges_len = range_count;
+
+	hhdm_ceil = ALIGN(_boot_meta.highest_address, 0x200000);
+
+	if (ARC_HHDM_EAGER_SIZE != 0) {
+		// Find the end of the first ARC_HHDM_EAGER_SIZE bytes of usable RAM
+		uint64_t left = ARC_HHDM_EAGER_SIZE;
+		uint64_t prefix = 0;
+
+		for (int i = 0; i < _boot_meta.arc_mmap_len && left > 0; i++) {
+			if (mmap[i].type != MULTIBOOT_MEMORY_AVAILABLE) {
+				continue;
+			}
+
+			uint64_t take = min(left, mmap[i].len);
+			prefix = max(prefix, mmap[i].base + take);
+			left -= take;
+		}
+
+		// Reserve the pool the kernel will use to map the rest
+		void *pool = alloc_tables(ARC_HHDM_POOL_PAGES);
+		void *lazy = Arc_ListAlloc(&physical_mem);
+
+		if (pool == NULL || lazy == NULL) {
+			ARC_DEBUG(ERR, "Failed to allocate HHDM page table pool\n");
+			return -1;
+		}
+
+		_boot_meta.hhdm_pool = (uintptr_t)pool;
+		_boot_meta.hhdm_pool_len = ARC_HHDM_POOL_PAGES;
+		_boot_meta.hhdm_lazy = (uintptr_t)lazy;
+
+		// Frames are freed in any order, so track the highest one
+		// allocated rather than trusting the head of the freelist
+		hhdm_ceil = ALIGN(max(prefix, (uintptr_t)physical_mem.highest + 0x1000), 0x200000);
+
+		ARC_DEBUG(INFO, "Eagerly mapping usable memory below 0x%"PRIx64"\n", hhdm_ceil);
+	}
+
+	if (hhdm_map_usable(0, hhdm_ceil) != 0) {
+		return -1;
+	}
+
+	// Usable memory is mapped above, the MMIO windows go last so
+	// they take precedence over anything they overlap
+	for (int i = 0; i < range_count; i++) {
+		if (i < _boot_meta.arc_mmap_len && mmap[i].type == MULTIBOOT_MEMORY_AVAILABLE) {
+			continue;
+		}
+
+		if (ranges[i].cache == ARC_CACHE_NONE) {
+			ARC_DEBUG(INFO, "Not mapping 0x%"PRIx64", 0x%"PRIx64" B\n", ranges[i].base, ranges[i].len);
+			continue;
+		}
+
+		ARC_DEBUG(INFO, "Mapping 0x%"PRIx64", 0x%"PRIx64" B (cache %d%s) into pml4\n", ranges[i].base, ranges[i].len, ranges[i].cache, ranges[i].read_only ? ", RO" : "");
+
+		pml4 = map_range(pml4, ranges[i].base + ARC_HHDM_VADDR, ranges[i].base, ranges[i].len, range_flags(&ranges[i]), 1);
+
+		if (pml4 == NULL) {
+			ARC_DEBUG(ERR, "Mapping failed\n");
+			return -1;
+		}
+	}
+
+	return 0;
+}
+
+int finalize_hhdm() {
+	if (ARC_HHDM_EAGER_SIZE == 0) {
+		return 0;
+	}
+
+	// Mapping may allocate more tables, so repeat until the
+	// highest frame allocated stays within the HHDM
+	uint64_t top = ALIGN((uintptr_t)physical_mem.highest + 0x1000, 0x200000);
+
+	while (top > hhdm_ceil) {
+		if (hhdm_map_usable(hhdm_ceil, top) != 0) {
+			return -1;
+		}
+
+		hhdm_ceil = top;
+		top = ALIGN((uintptr_t)physical_mem.highest + 0x1000, 0x200000);
+	}
+
+	// Record what is left for the kernel to map
+	struct ARC_MMap *mmap = (struct ARC_MMap *)((uint32_t)_boot_meta.arc_mmap);
+	struct ARC_MMap *lazy = (struct ARC_MMap *)((uint32_t)_boot_meta.hhdm_lazy);
+	int max_lazy = 0x1000 / sizeof(struct ARC_MMap);
+
+	_boot_meta.hhdm_lazy_len = 0;
+
+	for (int i = 0; i < _boot_meta.arc_mmap_len && _boot_meta.hhdm_lazy_len < max_lazy; i++) {
+		uint64_t end = mmap[i].base + mmap[i].len;
+
+		if (mmap[i].type != MULTIBOOT_MEMORY_AVAILABLE || end <= hhdm_ceil) {
+			continue;
+		}
+
+		struct ARC_MMap *range = &lazy[_boot_meta.hhdm_lazy_len++];
+		range->type = mmap[i].type;
+		range->base = max(mmap[i].base, hhdm_ceil);
+		range->len = end - range->base;
+
+		ARC_DEBUG(INFO, "Leaving 0x%"PRIx64", 0x%"PRIx64" B out of the HHDM\n", range->base, range->len);
+	}
+
+	return 0;
+}
+
+int renew_hhdm_pool() {
+	if (_boot_meta.hhdm_pool == 0) {
+		return 0;
+	}
+
+	void *pool = alloc_tables(ARC_HHDM_POOL_PAGES);
+
+	if (pool == NULL) {
+		ARC_DEBUG(ERR, "Failed to allocate HHDM page table pool\n");
+		return -1;
+	}
+
+	_boot_meta.hhdm_pool = (uintptr_t)pool;
+	_boot_meta.hhdm_pool_len = ARC_HHDM_POOL_PAGES;
+
+	return 0;
+}
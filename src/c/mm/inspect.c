@@ -0,0 +1,261 @@
+/**
+ * @file inspect.c
+ *
+ * @author awewsomegamer <awewsomegamer@gmail.com>
+ *
+ * @LICENSE
+ * Arctan-MB2BSP - Multiboot2 Bootstrapper for Arctan Kernel
+ * Copyright (C) 2023-2024 awewsomegamer
+ *
+ * This file is part of Arctan-MB2BSP
+ *
+ * Arctan is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; version 2
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * @DESCRIPTION
+ * Debug checks of the page tables handed to the kernel.
+*/
+#include <mm/inspect.h>
+#include <mm/ptwalk.h>
+#include <mm/freelist.h>
+#include <mm/vmm.h>
+#include <elf/elf.h>
+#include <multiboot/multiboot2.h>
+#include <global.h>
+
+/// Pages for a bitmap of every frame below 4 GiB.
+#define BITMAP_PAGES 32
+#define BITMAP_FRAMES (BITMAP_PAGES * 0x1000 * 8)
+
+struct inspect_state {
+	/// Frames in the PMM's freelist.
+	uint8_t *free;
+	/// Frames mapped outside of the HHDM and identity map.
+	uint8_t *mapped;
+	int problems;
+	uint32_t overlaps;
+};
+
+static int test_frame(uint8_t *bitmap, uint64_t paddr) {
+	uint64_t frame = paddr >> 12;
+	return frame < BITMAP_FRAMES && (bitmap[frame / 8] & (1 << (frame % 8)));
+}
+
+static void set_frame(uint8_t *bitmap, uint64_t paddr) {
+	uint64_t frame = paddr >> 12;
+
+	if (frame < BITMAP_FRAMES) {
+		bitmap[frame / 8] |= 1 << (frame % 8);
+	}
+}
+
+// Tables are all below 4 GiB and accessed through their physical address
+static uint64_t *read_table(uint64_t paddr, void *ctx) {
+	(void)ctx;
+
+	if (paddr >= 0x100000000ULL) {
+		return NULL;
+	}
+
+	return (uint64_t *)((uint32_t)paddr);
+}
+
+static void check_table(int level, uint64_t paddr, void *ctx) {
+	struct inspect_state *state = (struct inspect_state *)ctx;
+
+	if (test_frame(state->free, paddr)) {
+		ARC_DEBUG(ERR, "Level %d table 0x%"PRIx64" is a free frame\n", level, paddr)
+		state->problems++;
+	}
+}
+
+static void check_range(uint64_t vaddr, uint64_t paddr, uint64_t size, uint64_t flags, void *ctx) {
+	struct inspect_state *state = (struct inspect_state *)ctx;
+
+	ARC_DEBUG(INFO, "0x%016"PRIx64" -> 0x%"PRIx64" (0x%"PRIx64" B) %c%c%c%s%s\n", vaddr, paddr, size,
+		  (flags & ARC_PT_WRITE) ? 'W' : '-', (flags & ARC_PT_USER) ? 'U' : '-', (flags & ARC_PT_NX) ? '-' : 'X',
+		  (flags & ARC_PT_PCD) ? " UC" : "", (flags & ARC_PT_PAT) ? " PAT" : "")
+
+	// The HHDM and identity map cover free memory on purpose
+	if ((vaddr >= _boot_meta.hhdm_vaddr && vaddr - _boot_meta.hhdm_vaddr == paddr) || (vaddr == paddr && vaddr < 0x400000)) {
+		return;
+	}
+
+	int free = 0;
+
+	for (uint64_t offset = 0; offset < size && paddr + offset < 0x100000000ULL; offset += 0x1000) {
+		uint64_t frame = paddr + offset;
+
+		if (test_frame(state->free, frame)) {
+			free++;
+		}
+
+		if (test_frame(state->mapped, frame)) {
+			state->overlaps++;
+		}
+
+		set_frame(state->mapped, frame);
+	}
+
+	if (free != 0) {
+		ARC_DEBUG(ERR, "%d free frames mapped at 0x%"PRIx64"\n", free, vaddr)
+		state->problems++;
+	}
+}
+
+// Check that kernel segments are writable exactly when the ELF says so
+static int check_kernel(struct ARC_PTWalk *walk, uint64_t root) {
+	void *file = (void *)((uint32_t)_boot_meta.kernel_elf);
+	uint64_t vaddr = 0, size = 0;
+	int writable = 0;
+	int problems = 0;
+	int ret = 0;
+
+	for (int i = 0; (ret = elf_segment(file, i, &vaddr, &size, &writable)) >= 0; i++) {
+		if (ret != 0) {
+			continue;
+		}
+
+		uint64_t end = vaddr + size;
+
+		for (uint64_t page = vaddr & ~0xFFFULL; page < end;) {
+			uint64_t paddr = 0, flags = 0, page_size = 0;
+
+			if (pt_lookup(walk, root, page, &paddr, &flags, &page_size) != 0) {
+				ARC_DEBUG(ERR, "Kernel page 0x%"PRIx64" is not mapped\n", page)
+				problems++;
+				page += 0x1000;
+				continue;
+			}
+
+			uint64_t base = page & ~(page_size - 1);
+
+			// Pages shared with another segment may take either's permissions
+			if (base >= vaddr && base + page_size <= end && ((flags & ARC_PT_WRITE) != 0) != writable) {
+				ARC_DEBUG(ERR, "Kernel page 0x%"PRIx64" should%s be writable\n", page, writable ? "" : " not")
+				problems++;
+			}
+
+			page = base + page_size;
+		}
+	}
+
+	return problems;
+}
+
+// Check that all usable memory is either in the HHDM or left to the kernel
+static int check_hhdm(struct ARC_PTWalk *walk, uint64_t root) {
+	struct ARC_MMap *mmap = (struct ARC_MMap *)((uint32_t)_boot_meta.arc_mmap);
+	struct ARC_MMap *lazy = (struct ARC_MMap *)((uint32_t)_boot_meta.hhdm_lazy);
+	int problems = 0;
+
+	for (int i = 0; i < _boot_meta.arc_mmap_len; i++) {
+		if (mmap[i].type != MULTIBOOT_MEMORY_AVAILABLE) {
+			continue;
+		}
+
+		uint64_t end = mmap[i].base + mmap[i].len;
+
+		for (uint64_t paddr = mmap[i].base; paddr < end;) {
+			uint64_t mapped = 0, flags = 0, page_size = 0;
+
+			if (pt_lookup(walk, root, _boot_meta.hhdm_vaddr + paddr, &mapped, &flags, &page_size) == 0 && mapped == paddr) {
+				paddr = (paddr & ~(page_size - 1)) + page_size;
+				continue;
+			}
+
+			int j = 0;
+
+			for (; j < _boot_meta.hhdm_lazy_len; j++) {
+				if (paddr >= lazy[j].base && paddr < lazy[j].base + lazy[j].len) {
+					break;
+				}
+			}
+
+			if (j == _boot_meta.hhdm_lazy_len) {
+				ARC_DEBUG(ERR, "Usable frame 0x%"PRIx64" is missing from the HHDM\n", paddr)
+				problems++;
+				break;
+			}
+
+			paddr = lazy[j].base + lazy[j].len;
+		}
+	}
+
+	return problems;
+}
+
+int inspect_tables(uint64_t *pml4) {
+	struct inspect_state state = { 0 };
+
+	state.free = (uint8_t *)Arc_ListContiguousAlloc(&physical_mem, BITMAP_PAGES);
+	state.mapped = (uint8_t *)Arc_ListContiguousAlloc(&physical_mem, BITMAP_PAGES);
+
+	if (state.free == NULL || state.mapped == NULL) {
+		ARC_DEBUG(WARN, "Cannot allocate bitmaps, not inspecting page tables\n")
+
+		if (state.free != NULL) {
+			Arc_ListContiguousFree(&physical_mem, state.free, BITMAP_PAGES);
+		}
+
+		if (state.mapped != NULL) {
+			Arc_ListContiguousFree(&physical_mem, state.mapped, BITMAP_PAGES);
+		}
+
+		return 0;
+	}
+
+	fast_memset(state.free, 0, BITMAP_PAGES * 0x1000);
+	fast_memset(state.mapped, 0, BITMAP_PAGES * 0x1000);
+
+	for (struct ARC_FreelistNode *node = physical_mem.head; node != NULL; node = node->next) {
+		set_frame(state.free, (uintptr_t)node);
+	}
+
+	struct ARC_PTWalk walk = { 0 };
+	walk.levels = vmm_levels;
+	walk.read = read_table;
+	walk.table = check_table;
+	walk.range = check_range;
+	walk.ctx = &state;
+
+	uint64_t root = (uintptr_t)pml4;
+	pt_walk(&walk, root);
+
+	ARC_DEBUG(INFO, "Tables: %d PML5, %d PML4, %d PDPT, %d PD, %d PT (%d KiB)\n", walk.tables[5], walk.tables[4],
+		  walk.tables[3], walk.tables[2], walk.tables[1],
+		  (walk.tables[1] + walk.tables[2] + walk.tables[3] + walk.tables[4] + walk.tables[5]) * 4)
+	ARC_DEBUG(INFO, "Pages: %d 4 KiB, %d 2 MiB, %d 1 GiB\n", (uint32_t)walk.pages[0], (uint32_t)walk.pages[1], (uint32_t)walk.pages[2])
+
+	if (walk.unreadable != 0) {
+		ARC_DEBUG(ERR, "%d tables above 4 GiB could not be read\n", walk.unreadable)
+		state.problems++;
+	}
+
+	if (state.overlaps != 0) {
+		ARC_DEBUG(WARN, "%d frames are mapped more than once\n", state.overlaps)
+	}
+
+	if (_boot_meta.kernel_elf != 0) {
+		state.problems += check_kernel(&walk, root);
+	}
+
+	state.problems += check_hhdm(&walk, root);
+
+	Arc_ListContiguousFree(&physical_mem, state.mapped, BITMAP_PAGES);
+	Arc_ListContiguousFree(&physical_mem, state.free, BITMAP_PAGES);
+
+	ARC_DEBUG(INFO, "Page table inspection found %d problems\n", state.problems)
+
+	return state.problems;
+}
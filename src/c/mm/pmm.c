@@ -30,15 +30,13 @@
 #include <global.h>
 
 // Return 0: success
-int init_pmm(struct multiboot_tag_mmap *mmap, uintptr_t bootstrap_end) {
+int init_pmm(struct ARC_MMap *mmap, int entries, uintptr_t bootstrap_end) {
 	ARC_DEBUG(INFO, "Initializing PMM\n")
 
-	int entries = (mmap->size - sizeof(struct multiboot_tag_mmap)) / mmap->entry_size;
-
 	for (int i = 0; i < entries; i++) {
-		struct multiboot_mmap_entry entry = mmap->entries[i];
+		struct ARC_MMap entry = mmap[i];
 
-		if ((entry.addr < bootstrap_end && entry.addr + entry.len < bootstrap_end) || entry.type != MULTIBOOT_MEMORY_AVAILABLE) {
+		if ((entry.base < bootstrap_end && entry.base + entry.len < bootstrap_end) || entry.type != MULTIBOOT_MEMORY_AVAILABLE) {
 			// Entry not suitable for a freelist table
 			continue;
 		}
@@ -46,15 +44,15 @@ int init_pmm(struct multiboot_tag_mmap *mmap, uintptr_t bootstrap_end) {
 		// This entry either contains the bootstrap_end or is located after
 		ARC_DEBUG(INFO, "Entry %d suitable for freelist\n", i)
 
-		if ((uint32_t)(entry.addr >> 32) > 0) {
+		if ((uint32_t)(entry.base >> 32) > 0) {
 			ARC_DEBUG(INFO, "\tEntry %d is above 32-bit address range, ignoring\n", i)
 			continue;
 		}
 
-		void *base = (void *)((uint32_t)entry.addr);
-		void *ciel = (void *)((uint32_t)entry.addr + (uint32_t)entry.len - 0x1000);
+		void *base = (void *)((uint32_t)entry.base);
+		void *ciel = (void *)((uint32_t)entry.base + (uint32_t)entry.len - 0x1000);
 
-		if (entry.addr < bootstrap_end && entry.addr + entry.len > bootstrap_end) {
+		if (entry.base < bootstrap_end && entry.base + entry.len > bootstrap_end) {
 			// bootstrap_end contained is in this entry
 			base = (void *)ALIGN(bootstrap_end, 0x1000);
 		}
@@ -76,7 +74,107 @@ int init_pmm(struct multiboot_tag_mmap *mmap, uintptr_t bootstrap_end) {
 		}
 	}
 
+	// Hand the memory map off in memory of its own
+	int arc_mmap_size = ALIGN(entries * sizeof(struct ARC_MMap), 0x1000) / 0x1000;
+	struct ARC_MMap *arc_mmap = (struct ARC_MMap *)Arc_ListContiguousAlloc(&physical_mem, arc_mmap_size);
+
+	if (arc_mmap == NULL) {
+		ARC_DEBUG(ERR, "Failed to allocate memory map\n")
+		return -1;
+	}
+
+	fast_memset(arc_mmap, 0, arc_mmap_size * 0x1000);
+	fast_memcpy(arc_mmap, mmap, entries * sizeof(struct ARC_MMap));
+
+	_boot_meta.arc_mmap = (uintptr_t)arc_mmap;
+	_boot_meta.arc_mmap_len = entries;
+
 	ARC_DEBUG(INFO, "Initialized PMM\n")
 
 	return 0;
 }
+
+// Return: new number of entries, -1 on failure
+int pmm_split_mmap(struct ARC_MMap *mmap, int entries, uint64_t base, uint64_t len, int type) {
+	int i = 0;
+
+	while (i < entries && (mmap[i].type != MULTIBOOT_MEMORY_AVAILABLE || base < mmap[i].base || base + len > mmap[i].base + mmap[i].len)) {
+		i++;
+	}
+
+	if (i == entries) {
+		return -1;
+	}
+
+	struct ARC_MMap entry = mmap[i];
+	struct ARC_MMap pieces[3] = {
+		{ .type = entry.type, .base = entry.base, .len = base - entry.base },
+		{ .type = type, .base = base, .len = len },
+		{ .type = entry.type, .base = base + len, .len = entry.base + entry.len - base - len },
+	};
+
+	int count = 0;
+
+	for (int j = 0; j < 3; j++) {
+		count += pieces[j].len != 0;
+	}
+
+	if (entries + count - 1 > ARC_PMM_MAX_MMAP) {
+		return -1;
+	}
+
+	// Make room after the entry, then replace it with the pieces
+	for (int j = entries - 1; j > i; j--) {
+		mmap[j + count - 1] = mmap[j];
+	}
+
+	for (int j = 0; j < 3; j++) {
+		if (pieces[j].len != 0) {
+			mmap[i++] = pieces[j];
+		}
+	}
+
+	return entries + count - 1;
+}
+
+// Return 0: success
+int pmm_release(uint64_t base, uint64_t size) {
+	// Only whole pages, partial ones may be shared with something else
+	uint64_t start = ALIGN(base, 0x1000);
+	uint64_t end = (base + size) & ~0xFFFULL;
+
+	if (physical_mem.base == NULL || start >= end) {
+		return -1;
+	}
+
+	if (end - 0x1000 > (uintptr_t)physical_mem.ciel) {
+		// The last node of the freelist is never linked onwards,
+		// so the ceiling cannot be raised
+		ARC_DEBUG(ERR, "Cannot release 0x%"PRIx64" -> 0x%"PRIx64", above the freelist\n", start, end)
+		return -1;
+	}
+
+	struct ARC_MMap *mmap = (struct ARC_MMap *)((uint32_t)_boot_meta.arc_mmap);
+	int i = 0;
+
+	while (i < _boot_meta.arc_mmap_len && ((mmap[i].type != MULTIBOOT_MEMORY_AVAILABLE && mmap[i].type != ARC_MEMORY_BOOT_DATA) ||
+					       start < mmap[i].base || end > mmap[i].base + mmap[i].len)) {
+		i++;
+	}
+
+	if (i == _boot_meta.arc_mmap_len) {
+		ARC_DEBUG(ERR, "Cannot release 0x%"PRIx64" -> 0x%"PRIx64", not usable memory\n", start, end)
+		return -1;
+	}
+
+	if (start < (uintptr_t)physical_mem.base) {
+		physical_mem.base = (struct ARC_FreelistNode *)((uint32_t)start);
+	}
+
+	int pages = (end - start) / 0x1000;
+	Arc_ListContiguousFree(&physical_mem, (void *)((uint32_t)start), pages);
+
+	ARC_DEBUG(INFO, "Released %d page(s) at 0x%"PRIx64" to the PMM\n", pages, start)
+
+	return 0;
+}
@@ -0,0 +1,133 @@
+/**
+ * @file ptarena.c
+ *
+ * @author awewsomegamer <awewsomegamer@gmail.com>
+ *
+ * @LICENSE
+ * Arctan-MB2BSP - Multiboot2 Bootstrapper for Arctan Kernel
+ * Copyright (C) 2023-2024 awewsomegamer
+ *
+ * This file is part of Arctan-MB2BSP
+ *
+ * Arctan is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; version 2
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * @DESCRIPTION
+ * Contiguous arena of zeroed page tables.
+*/
+#include <mm/ptarena.h>
+#include <mm/vmm.h>
+#include <mm/hhdm.h>
+#include <mm/early.h>
+#include <mm/freelist.h>
+#include <elf/elf.h>
+#include <elf/plan.h>
+#include <elf/tls.h>
+#include <elf/driver.h>
+#include <arch/x86/tss.h>
+#include <global.h>
+#include <util.h>
+
+/// Base of the arena, NULL if there is none.
+static uint8_t *arena = NULL;
+/// Number of tables in the arena.
+static int arena_len = 0;
+/// Number of tables handed out from the arena.
+static int arena_used = 0;
+
+int create_table_arena() {
+	// PML4, identity map, HHDM, kernel, early regions, CPU descriptors
+	int count = 1;
+	count += count_tables(0, 0x400000, 0);
+	count += hhdm_count_tables();
+	int plan_tables = plan_count_tables();
+
+	if (plan_tables > 0) {
+		count += plan_tables;
+	} else {
+		count += elf_count_tables((void *)((uint32_t)_boot_meta.kernel_elf));
+	}
+
+	count += early_count_tables();
+	count += cpu_desc_count_tables();
+	count += tls_count_tables();
+	count += driver_count_tables();
+	count += ARC_PT_ARENA_SLACK;
+
+	arena = (uint8_t *)Arc_ListContiguousAlignedAlloc(&physical_mem, count, 0x1000);
+
+	if (arena == NULL) {
+		ARC_DEBUG(ERR, "Failed to allocate %d page tables\n", count);
+		return -1;
+	}
+
+	fast_memset(arena, 0, count * 0x1000);
+
+	arena_len = count;
+	arena_used = 0;
+
+	_boot_meta.pt_arena = (uintptr_t)arena;
+	_boot_meta.pt_arena_size = count * 0x1000;
+	_boot_meta.pt_arena_used = 0;
+
+	ARC_DEBUG(INFO, "Reserved %d page tables at 0x%"PRIxPTR"\n", count, (uintptr_t)arena);
+
+	return 0;
+}
+
+void *alloc_tables(int count) {
+	if (arena_used + count <= arena_len) {
+		void *tables = arena + arena_used * 0x1000;
+
+		arena_used += count;
+		_boot_meta.pt_arena_used = arena_used * 0x1000;
+
+		return tables;
+	}
+
+	static int warned = 0;
+
+	if (arena != NULL && !warned) {
+		ARC_DEBUG(WARN, "Page table arena exhausted\n");
+		warned = 1;
+	}
+
+	void *tables = count == 1 ? Arc_ListAlloc(&physical_mem) : Arc_ListContiguousAlloc(&physical_mem, count);
+
+	if (tables == NULL) {
+		return NULL;
+	}
+
+	fast_memset(tables, 0, count * 0x1000);
+
+	return tables;
+}
+
+void free_table(void *table) {
+	if (in_table_arena(table) && (uint8_t *)table == arena + (arena_used - 1) * 0x1000) {
+		// Last table handed out, lower the watermark
+		fast_memset(table, 0, 0x1000);
+		arena_used--;
+		_boot_meta.pt_arena_used = arena_used * 0x1000;
+
+		return;
+	}
+
+	// Anywhere else in the arena the frame can only go to the PMM,
+	// the arena is a watermark and cannot have holes
+	Arc_ListFree(&physical_mem, table);
+}
+
+int in_table_arena(void *table) {
+	return (uint8_t *)table >= arena && (uint8_t *)table < arena + arena_len * 0x1000;
+}
@@ -0,0 +1,173 @@
+/**
+ * @file ptwalk.c
+ *
+ * @author awewsomegamer <awewsomegamer@gmail.com>
+ *
+ * @LICENSE
+ * Arctan-MB2BSP - Multiboot2 Bootstrapper for Arctan Kernel
+ * Copyright (C) 2023-2024 awewsomegamer
+ *
+ * This file is part of Arctan-MB2BSP
+ *
+ * Arctan is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; version 2
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * @DESCRIPTION
+ * Page table walker shared by the bootstrapper and tools/ptinspect.
+*/
+#include <mm/ptwalk.h>
+
+// Flags of a page table entry, as ARC_PT_*, combined with those of its parents
+static uint64_t combine_flags(uint64_t entry, uint64_t parent, int leaf_level) {
+	uint64_t flags = entry & (ARC_PT_WRITE | ARC_PT_USER | ARC_PT_PWT | ARC_PT_PCD | ARC_PT_GLOBAL | ARC_PT_NX);
+
+	flags &= parent | ~(ARC_PT_WRITE | ARC_PT_USER);
+	flags |= parent & ARC_PT_NX;
+
+	if (leaf_level == 1 && (entry & (1 << 7))) {
+		flags |= ARC_PT_PAT;
+	} else if (leaf_level > 1 && (entry & (1 << 12))) {
+		flags |= ARC_PT_PAT;
+	}
+
+	return flags;
+}
+
+static uint64_t canonical(struct ARC_PTWalk *walk, uint64_t vaddr) {
+	int bits = 12 + 9 * walk->levels;
+
+	if ((vaddr >> (bits - 1)) & 1) {
+		vaddr |= ~((1ULL << bits) - 1);
+	}
+
+	return vaddr;
+}
+
+static void flush_run(struct ARC_PTWalk *walk) {
+	if (walk->run_size != 0 && walk->range != NULL) {
+		walk->range(walk->run_vaddr, walk->run_paddr, walk->run_size, walk->run_flags, walk->ctx);
+	}
+
+	walk->run_size = 0;
+}
+
+static void add_page(struct ARC_PTWalk *walk, uint64_t vaddr, uint64_t paddr, uint64_t size, uint64_t flags) {
+	if (walk->run_size != 0 && walk->run_vaddr + walk->run_size == vaddr
+	    && walk->run_paddr + walk->run_size == paddr && walk->run_flags == flags) {
+		walk->run_size += size;
+		return;
+	}
+
+	flush_run(walk);
+
+	walk->run_vaddr = vaddr;
+	walk->run_paddr = paddr;
+	walk->run_size = size;
+	walk->run_flags = flags;
+}
+
+static void walk_table(struct ARC_PTWalk *walk, uint64_t root, uint64_t paddr, int level, uint64_t vbase, uint64_t parent) {
+	uint64_t *table = walk->read(paddr, walk->ctx);
+
+	walk->tables[level]++;
+
+	if (walk->table != NULL) {
+		walk->table(level, paddr, walk->ctx);
+	}
+
+	if (table == NULL) {
+		walk->unreadable++;
+		return;
+	}
+
+	int shift = 12 + 9 * (level - 1);
+
+	for (int i = 0; i < 512; i++) {
+		uint64_t entry = table[i];
+
+		if ((entry & 1) == 0) {
+			continue;
+		}
+
+		uint64_t vaddr = vbase | ((uint64_t)i << shift);
+		int leaf = level == 1 || (level <= 3 && (entry & (1 << 7)));
+
+		if (leaf) {
+			uint64_t size = 1ULL << shift;
+			uint64_t frame = entry & ARC_PT_ADDRESS & ~(size - 1);
+
+			walk->pages[level - 1]++;
+			add_page(walk, canonical(walk, vaddr), frame, size, combine_flags(entry, parent, level));
+
+			continue;
+		}
+
+		if ((entry & ARC_PT_ADDRESS) == root) {
+			walk->recursive++;
+			continue;
+		}
+
+		walk_table(walk, root, entry & ARC_PT_ADDRESS, level - 1, vaddr, combine_flags(entry, parent, 0));
+	}
+}
+
+void pt_walk(struct ARC_PTWalk *walk, uint64_t root) {
+	for (int i = 0; i < 6; i++) {
+		walk->tables[i] = 0;
+	}
+
+	for (int i = 0; i < 3; i++) {
+		walk->pages[i] = 0;
+	}
+
+	walk->unreadable = 0;
+	walk->recursive = 0;
+	walk->run_size = 0;
+
+	// Everything is allowed until a level says otherwise
+	walk_table(walk, root, root, walk->levels, 0, ARC_PT_WRITE | ARC_PT_USER);
+	flush_run(walk);
+}
+
+int pt_lookup(struct ARC_PTWalk *walk, uint64_t root, uint64_t vaddr, uint64_t *paddr, uint64_t *flags, uint64_t *size) {
+	uint64_t table_paddr = root;
+	uint64_t parent = ARC_PT_WRITE | ARC_PT_USER;
+
+	for (int level = walk->levels; level > 0; level--) {
+		uint64_t *table = walk->read(table_paddr, walk->ctx);
+
+		if (table == NULL) {
+			return -1;
+		}
+
+		int shift = 12 + 9 * (level - 1);
+		uint64_t entry = table[(vaddr >> shift) & 0x1FF];
+
+		if ((entry & 1) == 0) {
+			return -1;
+		}
+
+		if (level == 1 || (level <= 3 && (entry & (1 << 7)))) {
+			*size = 1ULL << shift;
+			*paddr = (entry & ARC_PT_ADDRESS & ~(*size - 1)) + (vaddr & (*size - 1));
+			*flags = combine_flags(entry, parent, level);
+
+			return 0;
+		}
+
+		parent = combine_flags(entry, parent, 0);
+		table_paddr = entry & ARC_PT_ADDRESS;
+	}
+
+	return -1;
+}
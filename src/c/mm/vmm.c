@@ -27,6 +27,10 @@
 */
 #include <mm/vmm.h>
 #include <mm/freelist.h>
+#include <mm/ptarena.h>
+
+int vmm_large_pages = 1;
+int vmm_levels = 4;
 
 // Return NULL: error
 uint64_t *create_table(uint64_t *parent, uint64_t vaddr, int level) {
@@ -35,73 +39,275 @@ uint64_t *create_table(uint64_t *parent, uint64_t vaddr, int level) {
 	}
 
 	int shift = ((level - 1) * 9) + 12;
+	uint64_t entry = parent[(vaddr >> shift) & 0x1FF];
 
-	if ((parent[(vaddr >> shift) & 0x1FF] & 1) == 1) {
+	if ((entry & 1) == 1 && ((entry >> 7) & 1) == 0) {
 		// Entry already exists
-		return (uint64_t *)((uint32_t)(parent[(vaddr >> shift) & 0x1FF] & 0x0000FFFFFFFFF000));
+		return (uint64_t *)((uint32_t)(entry & 0x0000FFFFFFFFF000));
 	}
 
-	uint64_t *table = (uint64_t *)Arc_ListAlloc(&physical_mem);
+	uint64_t *table = (uint64_t *)alloc_tables(1);
 
 	if (table == NULL) {
 		ARC_DEBUG(ERR, "Failed to allocate new PML%d table for virtual address 0x%"PRIx64"\n", level, vaddr)
 		return NULL;
 	}
 
-	memset(table, 0, 0x1000);
+	if ((entry & 1) == 1) {
+		// Entry is a large page, split it up into the new table
+		uint64_t size = 1ULL << (shift - 9);
+		uint64_t base = entry & 0x0000FFFFFFFFF000 & ~((size << 9) - 1);
+		uint64_t flags = entry & 0x8000000000000FFF;
+
+		if (level == 2) {
+			// PML1 entries have no PS bit
+			flags &= ~(1 << 7);
+		}
+
+		for (int i = 0; i < 512; i++) {
+			table[i] = (base + i * size) | flags;
+		}
+	}
 
 	parent[(vaddr >> shift) & 0x1FF] = (uintptr_t)table | 3;
 	return table;
 }
 
+int count_tables(uint64_t vaddr, uint64_t size, int large) {
+	if (size == 0) {
+		return 0;
+	}
+
+	uint64_t end = vaddr + size - 1;
+	int pml4s = vmm_levels == 5 ? (end >> 48) - (vaddr >> 48) + 1 : 0;
+	int pml3s = (end >> 39) - (vaddr >> 39) + 1;
+	int pml2s = (end >> 30) - (vaddr >> 30) + 1;
+	int pml1s = (end >> 21) - (vaddr >> 21) + 1;
+
+	if (large && vmm_large_pages) {
+		// Only an unaligned head and tail need PML1 tables
+		pml1s = min(pml1s, 2);
+	}
+
+	return pml4s + pml3s + pml2s + pml1s;
+}
+
+// Return the table of the given level which contains the entry for vaddr
+// Return NULL: failure
+static uint64_t *get_table(uint64_t *pml4, uint64_t vaddr, int level) {
+	uint64_t *table = pml4;
+
+	for (int i = vmm_levels; i > level && table != NULL; i--) {
+		table = create_table(table, vaddr, i);
+	}
+
+	return table;
+}
+
 // Return PML4: success
 // Return NULL: failure
-uint64_t *map_page(uint64_t *pml4, uint64_t vaddr, uint64_t paddr, int overwrite) {
+uint64_t *map_page(uint64_t *pml4, uint64_t vaddr, uint64_t paddr, uint64_t flags, int overwrite) {
 	if (pml4 == NULL) {
-		pml4 = (uint64_t *)Arc_ListAlloc(&physical_mem);
-		memset(pml4, 0, 0x1000);
+		pml4 = (uint64_t *)alloc_tables(1);
 	}
 
-	// TODO: Check that the sign extension is correct
-
+	// Sign extension is ignored, every index is masked
 	paddr &= 0x0000FFFFFFFFF000;
-	vaddr &= 0x0000FFFFFFFFF000;
-
-	int err = 0;
-
-	uint64_t *pml3;
-	uint64_t *pml2;
-	uint64_t *pml1;
+	vaddr &= ~0xFFFULL;
 
-	err += (pml3 = create_table(pml4, vaddr, 4)) == NULL;
-	err += (pml2 = create_table(pml3, vaddr, 3)) == NULL;
-	err += (pml1 = create_table(pml2, vaddr, 2)) == NULL;
+	uint64_t *pml1 = get_table(pml4, vaddr, 1);
 
-	if (err > 0) {
+	if (pml1 == NULL) {
 		// One or more of the pointers are NULL, can't continue
 		ARC_DEBUG(ERR, "One or more errors encountered while getting / creating PML3, PML2, and PML1 tables\n")
 		return NULL;
 	}
 
-	if ((pml4[(vaddr >> 39) & 0x1FF] & 1) == 0) {
-		pml4[(vaddr >> 39) & 0x1FF] = ((uintptr_t)pml3) | 3;
+	if ((pml1[(vaddr >> 12) & 0x1FF] & 1) == 1 && !overwrite) {
+		// Cannot overwrite already existing entry
+		ARC_DEBUG(ERR, "Cannot overwrite 0x%"PRIx64":0x%"PRIx64"\n", vaddr, paddr)
+		return NULL;
 	}
 
-	if ((pml3[(vaddr >> 30) & 0x1FF] & 1) == 0) {
-		pml3[(vaddr >> 30) & 0x1FF] = ((uintptr_t)pml2) | 3;
+	pml1[(vaddr >> 12) & 0x1FF] = paddr | flags | 1;
+
+	return pml4;
+}
+
+// Return PML4: success
+// Return NULL: failure
+uint64_t *map_large_page(uint64_t *pml4, uint64_t vaddr, uint64_t paddr, uint64_t flags, int overwrite) {
+	if (pml4 == NULL) {
+		pml4 = (uint64_t *)alloc_tables(1);
 	}
 
-	if ((pml2[(vaddr >> 21) & 0x1FF] & 1) == 0) {
-		pml2[(vaddr >> 21) & 0x1FF] = ((uintptr_t)pml1) | 3;
+	paddr &= 0x0000FFFFFFE00000;
+	vaddr &= ~0x1FFFFFULL;
+
+	uint64_t *pml2 = get_table(pml4, vaddr, 2);
+
+	if (pml2 == NULL) {
+		ARC_DEBUG(ERR, "One or more errors encountered while getting / creating PML3 and PML2 tables\n")
+		return NULL;
 	}
 
-	if ((pml1[(vaddr >> 12) & 0x1FF] & 1) == 1 && !overwrite) {
-		// Cannot overwrite already existing entry
+	uint64_t entry = pml2[(vaddr >> 21) & 0x1FF];
+
+	if ((entry & 1) == 1 && (!overwrite || ((entry >> 7) & 1) == 0)) {
+		// Cannot overwrite an existing entry, or a PML1 table
+		// which would be lost
 		ARC_DEBUG(ERR, "Cannot overwrite 0x%"PRIx64":0x%"PRIx64"\n", vaddr, paddr)
 		return NULL;
 	}
 
-	pml1[(vaddr >> 12) & 0x1FF] = paddr | 3;
+	pml2[(vaddr >> 21) & 0x1FF] = paddr | flags | (1 << 7) | 1;
 
 	return pml4;
 }
+
+// Return PML4: success
+// Return NULL: failure
+uint64_t *map_range(uint64_t *pml4, uint64_t vaddr, uint64_t paddr, uint64_t size, uint64_t flags, int overwrite) {
+	uint64_t end = vaddr + size;
+
+	paddr -= vaddr & 0xFFF;
+	vaddr -= vaddr & 0xFFF;
+
+	while (vaddr < end) {
+		uint64_t page_size = 0x1000;
+
+		if (vmm_large_pages && ((vaddr | paddr) & 0x1FFFFF) == 0 && end - vaddr >= 0x200000) {
+			// Only use a large page if it would not replace an
+			// existing PML1 table
+			uint64_t *pml2 = get_table(pml4, vaddr, 2);
+			uint64_t entry = pml2 == NULL ? 0 : pml2[(vaddr >> 21) & 0x1FF];
+
+			if ((entry & 1) == 0 || ((entry >> 7) & 1) == 1) {
+				page_size = 0x200000;
+			}
+		}
+
+		if (page_size == 0x200000) {
+			pml4 = map_large_page(pml4, vaddr, paddr, flags, overwrite);
+		} else {
+			pml4 = map_page(pml4, vaddr, paddr, flags, overwrite);
+		}
+
+		if (pml4 == NULL) {
+			return NULL;
+		}
+
+		vaddr += page_size;
+		paddr += page_size;
+	}
+
+	return pml4;
+}
+
+// Return 0: vaddr is mapped, paddr is set
+int translate(uint64_t *pml4, uint64_t vaddr, uint64_t *paddr) {
+	uint64_t *table = pml4;
+
+	for (int level = vmm_levels; level > 0 && table != NULL; level--) {
+		int shift = ((level - 1) * 9) + 12;
+		uint64_t entry = table[(vaddr >> shift) & 0x1FF];
+
+		if ((entry & 1) == 0) {
+			return -1;
+		}
+
+		if (level == 1 || ((entry >> 7) & 1) == 1) {
+			uint64_t page_size = 1ULL << shift;
+			*paddr = (entry & 0x0000FFFFFFFFF000 & ~(page_size - 1)) + (vaddr & (page_size - 1));
+
+			return 0;
+		}
+
+		table = (uint64_t *)((uint32_t)(entry & 0x0000FFFFFFFFF000));
+	}
+
+	return -1;
+}
+
+// Collapse the given PML1 table into a single 2 MiB page if possible
+// Return 1: collapsed
+static int collapse_table(uint64_t *pml2, int index) {
+	uint64_t *pml1 = (uint64_t *)((uint32_t)(pml2[index] & 0x0000FFFFFFFFF000));
+	// Compare everything except the address and the accessed / dirty bits
+	uint64_t mask = 0x8000000000000FFF & ~((1 << 5) | (1 << 6));
+	uint64_t base = pml1[0] & 0x0000FFFFFFFFF000;
+	uint64_t flags = pml1[0] & mask;
+
+	if ((flags & 1) == 0 || (base & 0x1FFFFF) != 0 || ((flags >> 7) & 1) == 1) {
+		// Not present, physically misaligned, or uses the PAT bit
+		// which lives elsewhere in a PML2 entry
+		return 0;
+	}
+
+	for (int i = 1; i < 512; i++) {
+		if ((pml1[i] & 0x0000FFFFFFFFF000) != base + (i << 12) || (pml1[i] & mask) != flags) {
+			return 0;
+		}
+	}
+
+	pml2[index] = base | flags | (1 << 7);
+
+	free_table(pml1);
+
+	return 1;
+}
+
+// Collapse every PML1 table below the given table of the given level
+// Return number of PML1 tables collapsed
+static int promote_table(uint64_t *root, uint64_t *table, int level) {
+	int collapsed = 0;
+
+	for (int i = 0; i < 512; i++) {
+		uint64_t entry = table[i];
+
+		if ((entry & 1) == 0 || ((entry >> 7) & 1) == 1 || (entry & 0x0000FFFFFFFFF000) == (uintptr_t)root) {
+			// Not present, a large page, or the recursive slot
+			continue;
+		}
+
+		if (level == 2) {
+			collapsed += collapse_table(table, i);
+		} else {
+			collapsed += promote_table(root, (uint64_t *)((uint32_t)(entry & 0x0000FFFFFFFFF000)), level - 1);
+		}
+	}
+
+	return collapsed;
+}
+
+// Return number of PML1 tables collapsed
+int promote_pages(uint64_t *pml4) {
+	if (!vmm_large_pages) {
+		return 0;
+	}
+
+	int collapsed = promote_table(pml4, pml4, vmm_levels);
+
+	ARC_DEBUG(INFO, "Promoted %d 2 MiB page(s), freeing %d table(s) and saving %d TLB entries\n", collapsed, collapsed, collapsed * 511)
+
+	return collapsed;
+}
+
+// Return 0: success
+int install_recursive_slot(uint64_t *pml4, int slot) {
+	if (pml4 == NULL || slot < 256 || slot > 511) {
+		ARC_DEBUG(ERR, "Recursive slot %d is not in the higher half\n", slot)
+		return -1;
+	}
+
+	if ((pml4[slot] & 1) == 1) {
+		ARC_DEBUG(ERR, "Recursive slot %d is already in use\n", slot)
+		return -1;
+	}
+
+	pml4[slot] = (uintptr_t)pml4 | 3;
+
+	ARC_DEBUG(INFO, "Installed recursive mapping in slot %d\n", slot)
+
+	return 0;
+}
@@ -0,0 +1,173 @@
+/**
+ * @file module.c
+ *
+ * @author awewsomegamer <awewsomegamer@gmail.com>
+ *
+ * @LICENSE
+ * Arctan-MB2BSP - Multiboot2 Bootstrapper for Arctan Kernel
+ * Copyright (C) 2023-2024 awewsomegamer
+ *
+ * This file is part of Arctan-MB2BSP
+ *
+ * Arctan is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; version 2
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * @DESCRIPTION
+ * Table of the modules handed over to the kernel.
+*/
+#include <module/module.h>
+#include <mm/freelist.h>
+#include <global.h>
+#include <util.h>
+
+static struct ARC_Module modules[ARC_MODULE_MAX] = { 0 };
+static int module_total = 0;
+
+void module_add(char *cmdline, uint64_t paddr, uint64_t size, int type) {
+	if (module_total >= ARC_MODULE_MAX) {
+		ARC_DEBUG(WARN, "\tToo many modules, not handing over\n");
+		return;
+	}
+
+	struct ARC_Module *module = &modules[module_total++];
+
+	module->name_hash = name_hash(cmdline);
+	module->type = type;
+	module->paddr = paddr;
+	module->size = size;
+
+	for (int i = 0; i < ARC_MODULE_NAME_LEN - 1 && cmdline[i] != 0; i++) {
+		module->name[i] = cmdline[i];
+	}
+}
+
+// Return: non-zero if the module has not been released to the PMM
+static int module_present(struct ARC_Module *module) {
+	if (module->type == ARC_MODULE_KERNEL) {
+		return _boot_meta.kernel_elf == module->paddr;
+	}
+
+	return 1;
+}
+
+// Copy the module to page aligned memory
+// Return 0: success
+static int align_module(struct ARC_Module *module) {
+	int pages = ALIGN(module->size, 0x1000) / 0x1000;
+	void *copy = Arc_ListContiguousAlloc(&physical_mem, max(pages, 1));
+
+	if (copy == NULL) {
+		ARC_DEBUG(ERR, "Failed to allocate %d pages to align %s\n", pages, module->name);
+		return -1;
+	}
+
+	fast_memcpy(copy, (void *)((uint32_t)module->paddr), module->size);
+
+	ARC_DEBUG(INFO, "Moved %s from 0x%"PRIx64" to 0x%"PRIxPTR" to align it\n", module->name, module->paddr, (uintptr_t)copy);
+
+	module->paddr = (uintptr_t)copy;
+
+	// The bootstrapper's own references follow the module
+	switch (module->type) {
+	case ARC_MODULE_KERNEL: {
+		_boot_meta.kernel_elf = module->paddr;
+		break;
+	}
+
+	case ARC_MODULE_INITRAMFS: {
+		_boot_meta.initramfs = module->paddr;
+		break;
+	}
+
+	case ARC_MODULE_SNAPSHOT: {
+		_boot_meta.snapshot = module->paddr;
+		break;
+	}
+
+	case ARC_MODULE_BOOTPLAN: {
+		_boot_meta.boot_plan = module->paddr;
+		break;
+	}
+	}
+
+	return 0;
+}
+
+int create_module_table() {
+	int count = 0;
+	int err = 0;
+
+	for (int i = 0; i < module_total; i++) {
+		if (module_present(&modules[i])) {
+			count++;
+		}
+	}
+
+	if (count == 0) {
+		return 0;
+	}
+
+	uint32_t slots = 2;
+
+	while (slots < (uint32_t)count * 2) {
+		slots <<= 1;
+	}
+
+	uint32_t entries_size = count * sizeof(struct ARC_Module);
+	int pages = ALIGN(entries_size + slots * sizeof(uint16_t), 0x1000) / 0x1000;
+	struct ARC_Module *table = (struct ARC_Module *)Arc_ListContiguousAlloc(&physical_mem, pages);
+
+	if (table == NULL) {
+		ARC_DEBUG(ERR, "Failed to allocate module table\n");
+		return -1;
+	}
+
+	uint16_t *index = (uint16_t *)((uint8_t *)table + entries_size);
+	int j = 0;
+
+	fast_memset(table, 0, pages * 0x1000);
+
+	for (int i = 0; i < module_total; i++) {
+		struct ARC_Module *module = &modules[i];
+
+		if (!module_present(module)) {
+			continue;
+		}
+
+		if ((module->paddr & 0xFFF) != 0 && align_module(module) != 0) {
+			err = -1;
+			continue;
+		}
+
+		module->hhdm = _boot_meta.hhdm_vaddr + module->paddr;
+		table[j] = *module;
+
+		uint32_t slot = module->name_hash & (slots - 1);
+
+		while (index[slot] != 0) {
+			slot = (slot + 1) & (slots - 1);
+		}
+
+		index[slot] = j + 1;
+		j++;
+	}
+
+	_boot_meta.modules = (uintptr_t)table;
+	_boot_meta.modules_hhdm = _boot_meta.hhdm_vaddr + (uintptr_t)table;
+	_boot_meta.module_count = j;
+	_boot_meta.module_slots = slots;
+
+	ARC_DEBUG(INFO, "Handing over %d module(s) at 0x%"PRIxPTR"\n", j, (uintptr_t)table);
+
+	return err;
+}
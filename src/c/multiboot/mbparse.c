@@ -33,6 +33,11 @@
 #include <mm/freelist.h>
 #include <mm/pmm.h>
 #include <mm/vmm.h>
+#include <mm/hhdm.h>
+#include <record/record.h>
+#include <elf/driver.h>
+#include <verify/verify.h>
+#include <module/module.h>
 #include <arctan.h>
 #include <stdint.h>
 #include <interface/terminal.h>
@@ -42,6 +47,7 @@ struct ARC_MB2BootInfo {
         uint64_t fb;
 }__attribute__((packed));
 static struct ARC_MB2BootInfo mb2_boot_info = { 0 };
+static struct ARC_MMap mmap_entries[ARC_PMM_MAX_MMAP] = { 0 };
 
 int read_mb2i(void *mb2i) {
         ARC_DEBUG(INFO, "Reading multiboot information structure\n");
@@ -54,6 +60,14 @@ int read_mb2i(void *mb2i) {
 
         uint64_t bootstrap_end = (uintptr_t)&__BOOTSTRAP_END__;
 
+        uint32_t mb2i_size = *(uint32_t *)mb2i;
+        boot_record_avoid((uintptr_t)mb2i, mb2i_size);
+
+        if ((uintptr_t)mb2i + mb2i_size > bootstrap_end) {
+                // The information structure must not be handed out by the PMM
+                bootstrap_end = (uintptr_t)mb2i + mb2i_size;
+        }
+
         tag = (struct multiboot_tag *)((uintptr_t)tag + 8);
 
         int entries = 0;
@@ -66,6 +80,11 @@ int read_mb2i(void *mb2i) {
 
                         entries = (mmap->size - sizeof(struct multiboot_tag_mmap)) / mmap->entry_size;
 
+                        if (entries > ARC_PMM_MAX_MMAP) {
+                                ARC_DEBUG(WARN, "Only using the first %d of %d memory map entries\n", ARC_PMM_MAX_MMAP, entries);
+                                entries = ARC_PMM_MAX_MMAP;
+                        }
+
                         const char *names[] = {
                                 [MULTIBOOT_MEMORY_AVAILABLE] = "Available",
                                 [MULTIBOOT_MEMORY_ACPI_RECLAIMABLE] = "ACPI Reclaimable",
@@ -81,6 +100,10 @@ int read_mb2i(void *mb2i) {
                                         _boot_meta.highest_address = (uint64_t)(entry.addr + entry.len);
                                 }
 
+                                mmap_entries[i].base = entry.addr;
+                                mmap_entries[i].len = entry.len;
+                                mmap_entries[i].type = entry.type;
+
                                 ARC_DEBUG(INFO, "\t%4d : 0x%16llx, 0x%16llx B (%s)\n", i, entry.addr, entry.len, names[entry.type])
                         }
 
@@ -96,13 +119,35 @@ int read_mb2i(void *mb2i) {
                         ARC_DEBUG(INFO, "Found module: %s\n", info->cmdline);
                         ARC_DEBUG(INFO, "\t0x%"PRIx32" -> 0x%"PRIx32" (%d B)\n", info->mod_start, info->mod_end, (info->mod_end - info->mod_start))
 
-                        if (strcmp(info->cmdline, "arctan-module.kernel.elf") == 0) {
+                        int type = ARC_MODULE_OTHER;
+
+                        if (driver_add(info->cmdline, info->mod_start, info->mod_end - info->mod_start) == 0) {
+                                // Loaded after the kernel by load_drivers
+                                type = -1;
+                        } else if (strcmp(info->cmdline, "arctan-module.kernel.elf") == 0) {
                                 ARC_DEBUG(INFO, "\tFound kernel\n");
+                                type = ARC_MODULE_KERNEL;
                                 _boot_meta.kernel_elf = info->mod_start;
+                                _boot_meta.kernel_elf_size = info->mod_end - info->mod_start;
                         } else if (strcmp(info->cmdline, "arctan-module.initramfs.cpio") == 0) {
                                 ARC_DEBUG(INFO, "\tFound initramfs\n");
+                                type = ARC_MODULE_INITRAMFS;
                                 _boot_meta.initramfs = info->mod_start;
                                 _boot_meta.initramfs_size = info->mod_end - info->mod_start;
+                        } else if (strcmp(info->cmdline, "arctan-module.snapshot") == 0) {
+                                ARC_DEBUG(INFO, "\tFound snapshot\n");
+                                type = ARC_MODULE_SNAPSHOT;
+                                _boot_meta.snapshot = info->mod_start;
+                                _boot_meta.snapshot_size = info->mod_end - info->mod_start;
+                        } else if (strcmp(info->cmdline, "arctan-module.bootplan") == 0) {
+                                ARC_DEBUG(INFO, "\tFound boot plan\n");
+                                type = ARC_MODULE_BOOTPLAN;
+                                _boot_meta.boot_plan = info->mod_start;
+                                _boot_meta.boot_plan_size = info->mod_end - info->mod_start;
+                        }
+
+                        if (type >= 0) {
+                                module_add(info->cmdline, info->mod_start, info->mod_end - info->mod_start, type);
                         }
 
                         ARC_DEBUG(INFO, "----------------\n")
@@ -111,6 +156,8 @@ int read_mb2i(void *mb2i) {
                                 bootstrap_end = info->mod_end;
                         }
 
+                        boot_record_avoid(info->mod_start, info->mod_end - info->mod_start);
+
                         break;
                 }
 
@@ -124,6 +171,17 @@ int read_mb2i(void *mb2i) {
 
                         mb2_boot_info.fb = (uintptr_t)info;
 
+                        hhdm_add_mmio(common.framebuffer_addr, (uint64_t)common.framebuffer_pitch * common.framebuffer_height, ARC_CACHE_WC);
+
+                        break;
+                }
+
+                case MULTIBOOT_TAG_TYPE_CMDLINE: {
+                        struct multiboot_tag_string *info = (struct multiboot_tag_string *)tag;
+                        ARC_DEBUG(INFO, "Command line: %s\n", info->string);
+
+                        read_crc32c_args(info->string);
+
                         break;
                 }
 
@@ -150,6 +208,8 @@ int read_mb2i(void *mb2i) {
                         struct multiboot_tag_load_base_addr *info = (struct multiboot_tag_load_base_addr *)tag;
 
                         ARC_DEBUG(INFO, "Loaded at address: 0x%"PRIx32"\n", info->load_base_addr)
+
+                        break;
                 }
 
                 case MULTIBOOT_TAG_TYPE_ACPI_NEW:
@@ -164,37 +224,11 @@ int read_mb2i(void *mb2i) {
         ARC_DEBUG(INFO, "Finished reading multiboot information structure\n");
         ARC_DEBUG(INFO, "End of bootstrap 0x%"PRIx32" %\n", bootstrap_end)
 
-        init_pmm(mmap, (uintptr_t)bootstrap_end);
-
-        int arc_mmap_size = entries * sizeof(struct ARC_MMap) / 0x1000;
-        struct ARC_MMap *mmap_entries = (struct ARC_MMap *)Arc_ListContiguousAlloc(&physical_mem, arc_mmap_size);
-        memset(mmap_entries, 0, arc_mmap_size);
-
-        _boot_meta.arc_mmap = (uintptr_t)mmap_entries;
-        _boot_meta.arc_mmap_len = entries;
+        entries = reserve_boot_record(mmap_entries, entries);
 
-        // Create HHDM
-        _boot_meta.hhdm_vaddr = 0xFFFFC00000000000;
-        ARC_DEBUG(INFO, "Creating HHDM at 0x%"PRIx64"\n", ARC_HHDM_VADDR);
-
-        for (int i = 0; i < entries; i++) {
-                struct multiboot_mmap_entry entry = mmap->entries[i];
-
-                mmap_entries[i].base = entry.addr;
-                mmap_entries[i].len = entry.len;
-                mmap_entries[i].type = entry.type;
-
-                ARC_DEBUG(INFO, "Mapping entry %d (0x%"PRIx64", 0x%"PRIx64" B) into pml4\n", i, entry.addr, entry.len);
-
-                for (uint64_t j = 0; j < entry.len; j += 0x1000) {
-                        uint64_t linear = (uint64_t)(entry.addr + j);
-                        pml4 = map_page(pml4, linear + ARC_HHDM_VADDR, linear, 1);
-
-                        if (pml4 == NULL) {
-                                ARC_DEBUG(ERR, "Mapping failed\n");
-                                ARC_HANG
-                        }
-                }
+        if (mmap == NULL || init_pmm(mmap_entries, entries, (uintptr_t)bootstrap_end) != 0) {
+                ARC_DEBUG(ERR, "Failed to initialize PMM\n");
+                return -1;
         }
 
         _boot_meta.boot_info = (uintptr_t)&mb2_boot_info;
@@ -0,0 +1,220 @@
+/**
+ * @file pvh.c
+ *
+ * @author awewsomegamer <awewsomegamer@gmail.com>
+ *
+ * @LICENSE
+ * Arctan-MB2BSP - Multiboot2 Bootstrapper for Arctan Kernel
+ * Copyright (C) 2023-2024 awewsomegamer
+ *
+ * This file is part of Arctan-MB2BSP
+ *
+ * Arctan is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; version 2
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * @DESCRIPTION
+ * Provides a function for reading the PVH start information
+ * structure.
+*/
+#include <pvh/pvh.h>
+#include <global.h>
+#include <mm/pmm.h>
+#include <record/record.h>
+#include <elf/driver.h>
+#include <verify/verify.h>
+#include <module/module.h>
+#include <arctan.h>
+#include <util.h>
+
+static struct ARC_MMap mmap_entries[ARC_PMM_MAX_MMAP] = { 0 };
+
+static void read_module(struct hvm_modlist_entry *module) {
+	char *cmdline = module->cmdline_paddr != 0 ? (char *)((uint32_t)module->cmdline_paddr) : "";
+	uint8_t *data = (uint8_t *)((uint32_t)module->paddr);
+
+	ARC_DEBUG(INFO, "Found module: %s\n", cmdline);
+	ARC_DEBUG(INFO, "\t0x%"PRIx64" (0x%"PRIx64" B)\n", module->paddr, module->size);
+
+	if (driver_add(cmdline, module->paddr, module->size) == 0) {
+		return;
+	}
+
+	int is_kernel = strcmp(cmdline, "arctan-module.kernel.elf") == 0;
+	int is_initramfs = strcmp(cmdline, "arctan-module.initramfs.cpio") == 0;
+	int is_snapshot = strcmp(cmdline, "arctan-module.snapshot") == 0;
+	int is_plan = strcmp(cmdline, "arctan-module.bootplan") == 0;
+
+	if (!is_kernel && !is_initramfs && !is_snapshot && !is_plan) {
+		// Unnamed, tell by the contents
+		is_kernel = data[0] == 0x7F && data[1] == 'E' && data[2] == 'L' && data[3] == 'F';
+		is_snapshot = *(uint32_t *)data == ARC_SNAPSHOT_MAGIC;
+		is_plan = *(uint32_t *)data == ARC_PLAN_MAGIC;
+		is_initramfs = !is_kernel && !is_snapshot && !is_plan;
+	}
+
+	int type = ARC_MODULE_OTHER;
+
+	if (is_kernel && _boot_meta.kernel_elf == 0) {
+		ARC_DEBUG(INFO, "\tFound kernel\n");
+		type = ARC_MODULE_KERNEL;
+		_boot_meta.kernel_elf = module->paddr;
+		_boot_meta.kernel_elf_size = module->size;
+	} else if (is_initramfs && _boot_meta.initramfs == 0) {
+		ARC_DEBUG(INFO, "\tFound initramfs\n");
+		type = ARC_MODULE_INITRAMFS;
+		_boot_meta.initramfs = module->paddr;
+		_boot_meta.initramfs_size = module->size;
+	} else if (is_snapshot && _boot_meta.snapshot == 0) {
+		ARC_DEBUG(INFO, "\tFound snapshot\n");
+		type = ARC_MODULE_SNAPSHOT;
+		_boot_meta.snapshot = module->paddr;
+		_boot_meta.snapshot_size = module->size;
+	} else if (is_plan && _boot_meta.boot_plan == 0) {
+		ARC_DEBUG(INFO, "\tFound boot plan\n");
+		type = ARC_MODULE_BOOTPLAN;
+		_boot_meta.boot_plan = module->paddr;
+		_boot_meta.boot_plan_size = module->size;
+	}
+
+	module_add(cmdline, module->paddr, module->size, type);
+}
+
+// Give the pages of base to base + len which are still available
+// the type ARC_MEMORY_BOOT_DATA, so the PMM never hands them out
+// Return: new number of entries, -1 if the memory map is full or
+// entries is already -1
+static int reserve_boot_data(int entries, uint64_t base, uint64_t len) {
+	uint64_t start = base & ~0xFFFULL;
+	uint64_t end = ALIGN(base + len, 0x1000ULL);
+
+	if (entries < 0 || len == 0) {
+		// Failed earlier, or nothing to reserve
+		return entries;
+	}
+
+	for (int i = 0; i < entries; i++) {
+		uint64_t low = max(mmap_entries[i].base, start);
+		uint64_t high = min(mmap_entries[i].base + mmap_entries[i].len, end);
+
+		if (mmap_entries[i].type != MULTIBOOT_MEMORY_AVAILABLE || low >= high) {
+			continue;
+		}
+
+		entries = pmm_split_mmap(mmap_entries, entries, low, high - low, ARC_MEMORY_BOOT_DATA);
+
+		if (entries < 0) {
+			ARC_DEBUG(ERR, "Memory map full, cannot reserve 0x%"PRIx64", 0x%"PRIx64" B\n", base, len);
+			return -1;
+		}
+	}
+
+	return entries;
+}
+
+// Return: length of the string at paddr including its terminator
+static uint64_t string_size(uint64_t paddr) {
+	char *string = (char *)((uint32_t)paddr);
+	uint64_t size = 1;
+
+	while (*string++ != 0) {
+		size++;
+	}
+
+	return size;
+}
+
+int read_pvh(struct hvm_start_info *info) {
+	ARC_DEBUG(INFO, "Reading PVH start information (version %d)\n", info->version);
+
+	if (info->magic != XEN_HVM_START_MAGIC_VALUE || info->version < 1) {
+		// Version 0 has no memory map
+		ARC_DEBUG(ERR, "Unsupported start information\n");
+		return -1;
+	}
+
+	uint64_t bootstrap_end = (uintptr_t)&__BOOTSTRAP_END__;
+	bootstrap_end = max(bootstrap_end, (uintptr_t)info + sizeof(struct hvm_start_info));
+	boot_record_avoid((uintptr_t)info, sizeof(struct hvm_start_info));
+
+	struct hvm_memmap_table_entry *memmap = (struct hvm_memmap_table_entry *)((uint32_t)info->memmap_paddr);
+	uint64_t memmap_size = info->memmap_entries * sizeof(struct hvm_memmap_table_entry);
+	int entries = info->memmap_entries;
+
+	if (entries > ARC_PMM_MAX_MMAP) {
+		ARC_DEBUG(WARN, "Only using the first %d of %d memory map entries\n", ARC_PMM_MAX_MMAP, entries);
+		entries = ARC_PMM_MAX_MMAP;
+	}
+
+	for (int i = 0; i < entries; i++) {
+		mmap_entries[i].base = memmap[i].addr;
+		mmap_entries[i].len = memmap[i].size;
+		mmap_entries[i].type = memmap[i].type;
+
+		_boot_meta.highest_address = max(_boot_meta.highest_address, memmap[i].addr + memmap[i].size);
+
+		ARC_DEBUG(INFO, "\t%4d : 0x%16llx, 0x%16llx B (%d)\n", i, memmap[i].addr, memmap[i].size, memmap[i].type)
+	}
+
+	// Nothing the loader handed over may be handed out by the PMM,
+	// it can lie anywhere in memory, so it is reserved where it is
+	entries = reserve_boot_data(entries, info->memmap_paddr, memmap_size);
+	boot_record_avoid(info->memmap_paddr, memmap_size);
+
+	struct hvm_modlist_entry *modules = (struct hvm_modlist_entry *)((uint32_t)info->modlist_paddr);
+	uint64_t modlist_size = info->nr_modules * sizeof(struct hvm_modlist_entry);
+
+	entries = reserve_boot_data(entries, info->modlist_paddr, modlist_size);
+	boot_record_avoid(info->modlist_paddr, modlist_size);
+
+	for (uint32_t i = 0; i < info->nr_modules; i++) {
+		read_module(&modules[i]);
+
+		entries = reserve_boot_data(entries, modules[i].paddr, modules[i].size);
+		boot_record_avoid(modules[i].paddr, modules[i].size);
+
+		if (modules[i].cmdline_paddr != 0) {
+			uint64_t size = string_size(modules[i].cmdline_paddr);
+
+			entries = reserve_boot_data(entries, modules[i].cmdline_paddr, size);
+			boot_record_avoid(modules[i].cmdline_paddr, size);
+		}
+	}
+
+	if (info->cmdline_paddr != 0) {
+		uint64_t size = string_size(info->cmdline_paddr);
+
+		read_crc32c_args((char *)((uint32_t)info->cmdline_paddr));
+
+		entries = reserve_boot_data(entries, info->cmdline_paddr, size);
+		boot_record_avoid(info->cmdline_paddr, size);
+	}
+
+	if (entries < 0) {
+		return -1;
+	}
+
+	_boot_meta.rsdp = info->rsdp_paddr;
+
+	ARC_DEBUG(INFO, "End of bootstrap 0x%"PRIx64"\n", bootstrap_end)
+
+	entries = reserve_boot_record(mmap_entries, entries);
+
+	if (init_pmm(mmap_entries, entries, (uintptr_t)bootstrap_end) != 0) {
+		ARC_DEBUG(ERR, "Failed to initialize PMM\n");
+		return -1;
+	}
+
+	_boot_meta.boot_info = (uintptr_t)info;
+
+	return 0;
+}
@@ -0,0 +1,151 @@
+/**
+ * @file record.c
+ *
+ * @author awewsomegamer <awewsomegamer@gmail.com>
+ *
+ * @LICENSE
+ * Arctan-MB2BSP - Multiboot2 Bootstrapper for Arctan Kernel
+ * Copyright (C) 2023-2024 awewsomegamer
+ *
+ * This file is part of Arctan-MB2BSP
+ *
+ * Arctan is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; version 2
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * @DESCRIPTION
+ * Boot record of the last boot attempts, kept in a fixed page across
+ * resets.
+*/
+#include <record/record.h>
+#include <arch/x86/idt64.h>
+#include <arch/x86/msr.h>
+#include <mm/pmm.h>
+#include <global.h>
+#include <util.h>
+
+struct ARC_BootRecord *boot_record = NULL;
+static struct ARC_BootAttempt *attempt = NULL;
+/// Non-zero if the record at ARC_BOOT_RECORD_PADDR is intact.
+static int record_valid = 0;
+/// Non-zero if the loader handed something over in the record's page.
+static int record_taken = 0;
+static uint64_t entry_tsc = 0;
+
+static uint8_t record_sum() {
+	uint8_t sum = 0;
+
+	for (uint32_t i = 0; i < sizeof(struct ARC_BootRecord); i++) {
+		sum += ((uint8_t *)boot_record)[i];
+	}
+
+	return sum;
+}
+
+static void update_checksum() {
+	boot_record->checksum = 0;
+	boot_record->checksum = -record_sum();
+}
+
+void open_boot_record() {
+	entry_tsc = _x86_rdtsc();
+
+	if (ARC_BOOT_RECORD_PADDR == 0) {
+		return;
+	}
+
+	// Only read, whether the page may be written is not known yet
+	boot_record = (struct ARC_BootRecord *)ARC_BOOT_RECORD_PADDR;
+	record_valid = boot_record->magic == ARC_BOOT_RECORD_MAGIC && record_sum() == 0 && boot_record->next < ARC_BOOT_RECORD_SLOTS;
+	record_taken = 0;
+}
+
+void boot_record_avoid(uint64_t base, uint64_t len) {
+	if (base < ARC_BOOT_RECORD_PADDR + 0x1000 && ARC_BOOT_RECORD_PADDR < base + len) {
+		record_taken = 1;
+	}
+}
+
+void claim_boot_record() {
+	if (boot_record == NULL) {
+		return;
+	}
+
+	int found = 0;
+
+	if (record_valid) {
+		for (int i = 0; i < ARC_BOOT_RECORD_SLOTS; i++) {
+			found += boot_record->attempts[i].sequence != 0;
+		}
+	} else {
+		fast_memset(boot_record, 0, sizeof(struct ARC_BootRecord));
+		boot_record->magic = ARC_BOOT_RECORD_MAGIC;
+	}
+
+	int slot = boot_record->next;
+
+	boot_record->sequence++;
+	boot_record->next = (slot + 1) % ARC_BOOT_RECORD_SLOTS;
+
+	attempt = &boot_record->attempts[slot];
+
+	if (attempt->sequence != 0) {
+		// Overwriting the oldest attempt
+		found--;
+	}
+
+	fast_memset(attempt, 0, sizeof(struct ARC_BootAttempt));
+	attempt->sequence = boot_record->sequence;
+	attempt->phase = ARC_PHASE_ENTRY;
+	attempt->phase_tsc[ARC_PHASE_ENTRY] = entry_tsc;
+
+	crash_record = &attempt->crash;
+
+	_boot_meta.boot_record = (uintptr_t)boot_record;
+	_boot_meta.boot_record_slot = slot;
+	_boot_meta.boot_record_found = found;
+
+	update_checksum();
+}
+
+int reserve_boot_record(struct ARC_MMap *mmap, int entries) {
+	if (boot_record == NULL) {
+		return entries;
+	}
+
+	int new_entries = record_taken ? -1 : pmm_split_mmap(mmap, entries, (uintptr_t)boot_record, 0x1000, ARC_MEMORY_BOOT_RECORD);
+
+	if (new_entries < 0) {
+		ARC_DEBUG(WARN, "Boot record page 0x%"PRIxPTR" is not available memory or is in use, dropping the boot record\n", (uintptr_t)boot_record);
+
+		boot_record = NULL;
+
+		return entries;
+	}
+
+	claim_boot_record();
+
+	ARC_DEBUG(INFO, "Boot attempt %d, %d earlier attempt(s) in the boot record\n", boot_record->sequence, _boot_meta.boot_record_found);
+
+	return new_entries;
+}
+
+void boot_phase(int phase) {
+	if (attempt == NULL || phase < 0 || phase >= ARC_PHASE_COUNT) {
+		return;
+	}
+
+	attempt->phase = phase;
+	attempt->phase_tsc[phase] = _x86_rdtsc();
+
+	update_checksum();
+}
@@ -0,0 +1,204 @@
+/**
+ * @file snapshot.c
+ *
+ * @author awewsomegamer <awewsomegamer@gmail.com>
+ *
+ * @LICENSE
+ * Arctan-MB2BSP - Multiboot2 Bootstrapper for Arctan Kernel
+ * Copyright (C) 2023-2024 awewsomegamer
+ *
+ * This file is part of Arctan-MB2BSP
+ *
+ * Arctan is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; version 2
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * @DESCRIPTION
+ * Resuming a kernel from a memory snapshot module.
+*/
+#include <snapshot/snapshot.h>
+#include <arch/x86/cpuid.h>
+#include <mm/vmm.h>
+#include <global.h>
+
+struct ARC_SnapshotContext *resume_context = NULL;
+static struct ARC_SnapshotContext context = { 0 };
+
+static int overlaps(uint32_t a, uint32_t a_len, uint32_t b, uint32_t b_len) {
+	return a < b + b_len && b < a + a_len;
+}
+
+static struct ARC_SnapshotExtent *next_extent(struct ARC_SnapshotExtent *extent) {
+	return (struct ARC_SnapshotExtent *)((void *)(extent + 1) + ALIGN((uint32_t)extent->size, 8));
+}
+
+// Decode an ARC_SNAPSHOT_RLE stream into dest, or only walk it if dest is NULL
+// Return: number of qwords decoded, -1 if the stream is malformed or
+// decodes to more than max qwords
+static int decode_rle(uint8_t *data, uint32_t size, uint64_t *dest, int max) {
+	uint8_t *end = data + size;
+	int decoded = 0;
+
+	while (data + sizeof(uint32_t) <= end) {
+		uint32_t header = *(uint32_t *)data;
+		int count = header & 0x7FFFFFFF;
+		int literal = (header >> 31) & 1;
+		uint32_t data_size = (literal ? count : 1) * sizeof(uint64_t);
+
+		data += sizeof(uint32_t);
+
+		if (count > max - decoded || data + data_size > end) {
+			return -1;
+		}
+
+		if (dest != NULL && literal) {
+			fast_memcpy(&dest[decoded], data, data_size);
+		} else if (dest != NULL) {
+			for (int i = 0; i < count; i++) {
+				dest[decoded + i] = *(uint64_t *)data;
+			}
+		}
+
+		data += data_size;
+		decoded += count;
+	}
+
+	return data == end ? decoded : -1;
+}
+
+// Return 1: base to base + len lies within available memory, possibly
+// spanning adjacent entries
+static int is_available(uint64_t base, uint64_t len) {
+	struct ARC_MMap *mmap = (struct ARC_MMap *)((uint32_t)_boot_meta.arc_mmap);
+	uint64_t end = base + len;
+
+	while (base < end) {
+		int i = 0;
+
+		while (i < _boot_meta.arc_mmap_len && (mmap[i].type != MULTIBOOT_MEMORY_AVAILABLE || base < mmap[i].base ||
+						       base >= mmap[i].base + mmap[i].len)) {
+			i++;
+		}
+
+		if (i == _boot_meta.arc_mmap_len) {
+			return 0;
+		}
+
+		base = mmap[i].base + mmap[i].len;
+	}
+
+	return 1;
+}
+
+// Return 0: the extent can be restored
+static int check_extent(struct ARC_SnapshotExtent *extent, void *end) {
+	uint8_t *data = (uint8_t *)(extent + 1);
+	uint64_t len = (uint64_t)extent->pages * 0x1000;
+
+	if ((void *)data > end || extent->size > (uint32_t)(end - (void *)data)) {
+		return -1;
+	}
+
+	if ((extent->paddr & 0xFFF) != 0 || extent->paddr + len > 0x100000000) {
+		return -1;
+	}
+
+	uint32_t paddr = extent->paddr;
+	uint32_t bootstrap_start = 0x100000;
+	uint32_t bootstrap_end = (uintptr_t)&__BOOTSTRAP_END__;
+
+	if (overlaps(paddr, len, bootstrap_start, bootstrap_end - bootstrap_start) ||
+	    overlaps(paddr, len, _boot_meta.snapshot, _boot_meta.snapshot_size)) {
+		return -1;
+	}
+
+	// The boot record is written again at handoff, after the restore
+	if (!is_available(paddr, len) || (_boot_meta.boot_record != 0 && overlaps(paddr, len, _boot_meta.boot_record, 0x1000))) {
+		return -1;
+	}
+
+	switch (extent->encoding) {
+	case ARC_SNAPSHOT_RAW:
+		return extent->size == len ? 0 : -1;
+	case ARC_SNAPSHOT_ZERO:
+		return 0;
+	case ARC_SNAPSHOT_RLE:
+		return decode_rle(data, extent->size, NULL, len / sizeof(uint64_t)) == (int)(len / sizeof(uint64_t)) ? 0 : -1;
+	}
+
+	return -1;
+}
+
+static void restore_extent(struct ARC_SnapshotExtent *extent) {
+	void *dest = (void *)((uint32_t)extent->paddr);
+	void *data = (void *)(extent + 1);
+	uint32_t len = extent->pages * 0x1000;
+
+	switch (extent->encoding) {
+	case ARC_SNAPSHOT_RAW:
+		fast_memcpy(dest, data, len);
+		break;
+	case ARC_SNAPSHOT_ZERO:
+		fast_memset(dest, 0, len);
+		break;
+	case ARC_SNAPSHOT_RLE:
+		decode_rle(data, extent->size, dest, len / sizeof(uint64_t));
+		break;
+	}
+}
+
+int restore_snapshot() {
+	struct ARC_SnapshotHeader *header = (struct ARC_SnapshotHeader *)((uint32_t)_boot_meta.snapshot);
+	void *end = (void *)header + _boot_meta.snapshot_size;
+
+	if (_boot_meta.snapshot_size < sizeof(struct ARC_SnapshotHeader) || header->magic != ARC_SNAPSHOT_MAGIC) {
+		ARC_DEBUG(ERR, "Snapshot is corrupt\n");
+		return -1;
+	}
+
+	int la57 = (header->context.cr4 >> 12) & 1;
+
+	if ((header->context.cr3 >> 32) != 0 || (la57 && (cpu_features & ARC_CPU_FEATURE_LA57) == 0)) {
+		ARC_DEBUG(ERR, "Snapshot context cannot be resumed\n");
+		return -1;
+	}
+
+	// Check everything first, nothing may be written unless
+	// the whole snapshot can be restored
+	struct ARC_SnapshotExtent *extent = (struct ARC_SnapshotExtent *)(header + 1);
+
+	for (uint32_t i = 0; i < header->extent_count; i++) {
+		if (check_extent(extent, end) != 0) {
+			ARC_DEBUG(ERR, "Snapshot extent %d cannot be restored\n", i);
+			return -1;
+		}
+
+		extent = next_extent(extent);
+	}
+
+	extent = (struct ARC_SnapshotExtent *)(header + 1);
+
+	for (uint32_t i = 0; i < header->extent_count; i++) {
+		restore_extent(extent);
+		extent = next_extent(extent);
+	}
+
+	context = header->context;
+
+	pml4 = (uint64_t *)((uint32_t)context.cr3);
+	vmm_levels = la57 ? 5 : 4;
+	resume_context = &context;
+
+	ARC_DEBUG(INFO, "Restored %d extent(s), resuming at 0x%"PRIx64"\n", header->extent_count, context.rip);
+
+	return 0;
+}
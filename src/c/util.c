@@ -26,6 +26,11 @@
  * Utility functions.
 */
 #include <util.h>
+#include <arch/x86/cpuid.h>
+#include <arch/x86/memory.h>
+
+/// Fills at least this large bypass the cache.
+#define NON_TEMPORAL_THRESHOLD 0x100000
 
 int strcmp(char *a, char *b) {
 	int sum = 0;
@@ -39,6 +44,25 @@ int strcmp(char *a, char *b) {
 	return sum;
 }
 
+int names_equal(char *a, char *b) {
+	while (*a != 0 && *a == *b) {
+		a++;
+		b++;
+	}
+
+	return *a == *b;
+}
+
+uint32_t name_hash(char *name) {
+	uint32_t hash = 0x811C9DC5;
+
+	while (*name != 0) {
+		hash = (hash ^ (uint8_t)*name++) * 0x01000193;
+	}
+
+	return hash;
+}
+
 int memcpy(void *a, void *b, size_t size) {
 	size_t i = 0;
 	while (i < size) {
@@ -57,3 +81,32 @@ void memset(void *mem, uint8_t value, size_t size) {
 		*(uint8_t *)(mem + i) = value;
 	}
 }
+
+void fast_memcpy(void *a, void *b, size_t size) {
+	if ((cpu_features & ARC_CPU_FEATURE_ERMS) != 0) {
+		_x86_memcpy_movsb(a, b, size);
+		return;
+	}
+
+	_x86_memcpy_movsd(a, b, size);
+}
+
+void fast_memset(void *mem, uint8_t value, size_t size) {
+	uint32_t pattern = value * 0x01010101;
+
+	if (size >= NON_TEMPORAL_THRESHOLD && (cpu_features & ARC_CPU_FEATURE_SSE2) != 0 && ((uintptr_t)mem & 3) == 0) {
+		size_t bulk = size & ~31;
+
+		_x86_memset_movnti(mem, pattern, bulk);
+
+		mem += bulk;
+		size -= bulk;
+	}
+
+	if ((cpu_features & ARC_CPU_FEATURE_ERMS) != 0) {
+		_x86_memset_stosb(mem, pattern, size);
+		return;
+	}
+
+	_x86_memset_stosd(mem, pattern, size);
+}
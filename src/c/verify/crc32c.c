@@ -0,0 +1,129 @@
+/**
+ * @file crc32c.c
+ *
+ * @author awewsomegamer <awewsomegamer@gmail.com>
+ *
+ * @LICENSE
+ * Arctan-MB2BSP - Multiboot2 Bootstrapper for Arctan Kernel
+ * Copyright (C) 2023-2024 awewsomegamer
+ *
+ * This file is part of Arctan-MB2BSP
+ *
+ * Arctan is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; version 2
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * @DESCRIPTION
+ * CRC32C (Castagnoli) checksums.
+*/
+#include <verify/crc32c.h>
+#include <arch/x86/crc32c.h>
+#include <arch/x86/cpuid.h>
+#include <global.h>
+
+/// CRC32C polynomial, bit reflected.
+#define CRC32C_POLY 0x82F63B78
+/// Bytes of each stream given to _x86_crc32c_3way.
+#define STREAM_LEN 0x1000
+
+/// Slicing-by-8 tables, table[k][b] is the CRC of b followed by k zero bytes.
+static uint32_t table[8][256] = { 0 };
+/// Advances a CRC register over STREAM_LEN zero bytes, a byte at a time.
+static uint32_t shift_table[4][256] = { 0 };
+static int tables_ready = 0;
+
+// Return: the register advanced over eight bytes, the first four
+// of which have already been XORed into crc
+static uint32_t slice8(uint32_t crc, uint32_t high) {
+	return table[7][crc & 0xFF] ^ table[6][(crc >> 8) & 0xFF] ^ table[5][(crc >> 16) & 0xFF] ^ table[4][crc >> 24]
+	       ^ table[3][high & 0xFF] ^ table[2][(high >> 8) & 0xFF] ^ table[1][(high >> 16) & 0xFF] ^ table[0][high >> 24];
+}
+
+static void init_tables() {
+	for (int i = 0; i < 256; i++) {
+		uint32_t crc = i;
+
+		for (int j = 0; j < 8; j++) {
+			crc = (crc & 1) ? (crc >> 1) ^ CRC32C_POLY : crc >> 1;
+		}
+
+		table[0][i] = crc;
+	}
+
+	for (int i = 0; i < 256; i++) {
+		for (int k = 1; k < 8; k++) {
+			table[k][i] = (table[k - 1][i] >> 8) ^ table[0][table[k - 1][i] & 0xFF];
+		}
+	}
+
+	// The register is linear, so advancing it over zeros is a sum of
+	// the advanced values of each of its bytes
+	for (int k = 0; k < 4; k++) {
+		for (int i = 0; i < 256; i++) {
+			uint32_t crc = (uint32_t)i << (8 * k);
+
+			for (int j = 0; j < STREAM_LEN / 8; j++) {
+				crc = slice8(crc, 0);
+			}
+
+			shift_table[k][i] = crc;
+		}
+	}
+
+	tables_ready = 1;
+}
+
+static uint32_t shift(uint32_t crc) {
+	return shift_table[0][crc & 0xFF] ^ shift_table[1][(crc >> 8) & 0xFF]
+	       ^ shift_table[2][(crc >> 16) & 0xFF] ^ shift_table[3][crc >> 24];
+}
+
+static uint32_t crc32c_soft(uint32_t crc, uint8_t *data, size_t size) {
+	for (; size >= 8; size -= 8, data += 8) {
+		crc = slice8(crc ^ *(uint32_t *)data, *(uint32_t *)(data + 4));
+	}
+
+	for (; size > 0; size--) {
+		crc = (crc >> 8) ^ table[0][(crc ^ *data++) & 0xFF];
+	}
+
+	return crc;
+}
+
+static uint32_t crc32c_hard(uint32_t crc, uint8_t *data, size_t size) {
+	for (; size >= 3 * STREAM_LEN; size -= 3 * STREAM_LEN, data += 3 * STREAM_LEN) {
+		uint32_t crcs[3] = { crc, 0, 0 };
+
+		_x86_crc32c_3way(crcs, data, STREAM_LEN);
+
+		// Append the second and third streams to the first
+		crc = shift(shift(crcs[0]) ^ crcs[1]) ^ crcs[2];
+	}
+
+	return _x86_crc32c(crc, data, size);
+}
+
+uint32_t crc32c(uint32_t crc, void *data, size_t size) {
+	if (!tables_ready) {
+		init_tables();
+	}
+
+	crc = ~crc;
+
+	if (cpu_features & ARC_CPU_FEATURE_SSE42) {
+		crc = crc32c_hard(crc, (uint8_t *)data, size);
+	} else {
+		crc = crc32c_soft(crc, (uint8_t *)data, size);
+	}
+
+	return ~crc;
+}
@@ -0,0 +1,145 @@
+/**
+ * @file verify.c
+ *
+ * @author awewsomegamer <awewsomegamer@gmail.com>
+ *
+ * @LICENSE
+ * Arctan-MB2BSP - Multiboot2 Bootstrapper for Arctan Kernel
+ * Copyright (C) 2023-2024 awewsomegamer
+ *
+ * This file is part of Arctan-MB2BSP
+ *
+ * Arctan is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; version 2
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * @DESCRIPTION
+ * Integrity checks of the kernel and initramfs modules.
+*/
+#include <verify/verify.h>
+#include <verify/crc32c.h>
+#include <arch/x86/msr.h>
+#include <global.h>
+
+static uint32_t expected_kernel = 0;
+static uint32_t expected_initramfs = 0;
+/// ARC_CRC32C_*_CHECKED for each module an expected CRC32C was given for.
+static uint32_t expected = 0;
+
+// Read arg if it is "name=<hex>", setting end to the character after it
+// Return 0: value was read
+static int read_arg(char *arg, char *name, uint32_t *value, char **end) {
+	while (*name != 0) {
+		if (*arg++ != *name++) {
+			return -1;
+		}
+	}
+
+	if (arg[0] == '0' && (arg[1] == 'x' || arg[1] == 'X')) {
+		arg += 2;
+	}
+
+	uint32_t result = 0;
+	int digits = 0;
+
+	for (;; arg++, digits++) {
+		char c = *arg;
+
+		if (c >= '0' && c <= '9') {
+			result = (result << 4) | (c - '0');
+		} else if (c >= 'a' && c <= 'f') {
+			result = (result << 4) | (c - 'a' + 10);
+		} else if (c >= 'A' && c <= 'F') {
+			result = (result << 4) | (c - 'A' + 10);
+		} else {
+			break;
+		}
+	}
+
+	*end = arg;
+
+	if (digits == 0 || digits > 8 || (*arg != 0 && *arg != ' ')) {
+		return -1;
+	}
+
+	*value = result;
+
+	return 0;
+}
+
+void read_crc32c_args(char *cmdline) {
+	while (*cmdline != 0) {
+		char *end = cmdline;
+
+		if (read_arg(cmdline, "crc32c.kernel=", &expected_kernel, &end) == 0) {
+			expected |= ARC_CRC32C_KERNEL_CHECKED;
+		} else if (read_arg(cmdline, "crc32c.initramfs=", &expected_initramfs, &end) == 0) {
+			expected |= ARC_CRC32C_INITRAMFS_CHECKED;
+		}
+
+		// Skip to the next argument
+		while (*end != 0 && *end != ' ') {
+			end++;
+		}
+
+		while (*end == ' ') {
+			end++;
+		}
+
+		cmdline = end;
+	}
+}
+
+// Return 0: the module matches value
+static int check_module(char *name, uint64_t base, uint32_t size, uint32_t value, uint32_t *crc) {
+	*crc = crc32c(0, (void *)((uint32_t)base), size);
+
+	if (*crc != value) {
+		ARC_DEBUG(ERR, "%s CRC32C is 0x%08x, expected 0x%08x\n", name, *crc, value);
+		return -1;
+	}
+
+	ARC_DEBUG(INFO, "%s CRC32C 0x%08x matches\n", name, *crc);
+
+	return 0;
+}
+
+int verify_modules() {
+	uint64_t start = _x86_rdtsc();
+	uint32_t crc = 0;
+	int err = 0;
+
+	if ((expected & ARC_CRC32C_KERNEL_CHECKED) && _boot_meta.kernel_elf != 0) {
+		_boot_meta.crc32c_status |= ARC_CRC32C_KERNEL_CHECKED;
+
+		if (check_module("Kernel", _boot_meta.kernel_elf, _boot_meta.kernel_elf_size, expected_kernel, &crc) != 0) {
+			_boot_meta.crc32c_status |= ARC_CRC32C_KERNEL_BAD;
+			err = -1;
+		}
+
+		_boot_meta.kernel_crc32c = crc;
+	}
+
+	if ((expected & ARC_CRC32C_INITRAMFS_CHECKED) && _boot_meta.initramfs != 0) {
+		_boot_meta.crc32c_status |= ARC_CRC32C_INITRAMFS_CHECKED;
+
+		if (check_module("Initramfs", _boot_meta.initramfs, _boot_meta.initramfs_size, expected_initramfs, &crc) != 0) {
+			_boot_meta.crc32c_status |= ARC_CRC32C_INITRAMFS_BAD;
+		}
+
+		_boot_meta.initramfs_crc32c = crc;
+	}
+
+	_boot_meta.crc32c_tsc = _x86_rdtsc() - start;
+
+	return err;
+}
@@ -0,0 +1,288 @@
+/**
+ * @file warm.c
+ *
+ * @author awewsomegamer <awewsomegamer@gmail.com>
+ *
+ * @LICENSE
+ * Arctan-MB2BSP - Multiboot2 Bootstrapper for Arctan Kernel
+ * Copyright (C) 2023-2024 awewsomegamer
+ *
+ * This file is part of Arctan-MB2BSP
+ *
+ * Arctan is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; version 2
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * @DESCRIPTION
+ * Warm reboots, which load a new kernel into the address space
+ * built by the previous boot.
+*/
+#include <warm/warm.h>
+#include <mm/vmm.h>
+#include <mm/ptwalk.h>
+#include <mm/freelist.h>
+#include <global.h>
+
+/**
+ * External assembly function, the 64-bit entry point.
+ * */
+extern void _warm_entry();
+
+static struct ARC_WarmDesc warm_desc = { 0 };
+
+/// Tables of the identity map and HHDM, kept by rebuild_pmm, ascending.
+static uint32_t kept_tables[ARC_WARM_MAX_TABLES] = { 0 };
+static int kept_count = 0;
+
+struct warm_range {
+	uint64_t base;
+	uint64_t end;
+};
+
+static uint8_t byte_sum(void *base, uint32_t length) {
+	uint8_t sum = 0;
+
+	for (uint32_t i = 0; i < length; i++) {
+		sum += *(uint8_t *)(base + i);
+	}
+
+	return sum;
+}
+
+static uint32_t hhdm_sum(uint64_t *root, uint32_t first, uint32_t last) {
+	uint32_t sum = 0;
+
+	for (uint32_t i = first; i <= last; i++) {
+		sum += (uint32_t)root[i] + (uint32_t)(root[i] >> 32);
+	}
+
+	return sum;
+}
+
+static int is_hhdm_slot(int slot) {
+	return slot >= (int)warm_desc.hhdm_first_slot && slot <= (int)warm_desc.hhdm_last_slot;
+}
+
+int create_warm_desc() {
+	int shift = vmm_levels == 5 ? 48 : 39;
+	uint64_t hhdm_end = _boot_meta.hhdm_vaddr + _boot_meta.highest_address - 1;
+
+	warm_desc.magic = ARC_WARM_MAGIC;
+	warm_desc.checksum = 0;
+	warm_desc.boot_meta = (uintptr_t)&_boot_meta;
+	warm_desc.pmm_state = (uintptr_t)&physical_mem;
+	warm_desc.pmm_base = (uintptr_t)physical_mem.base;
+	warm_desc.pmm_ciel = (uintptr_t)physical_mem.ciel;
+	warm_desc.pml4 = (uintptr_t)pml4;
+	warm_desc.levels = vmm_levels;
+	warm_desc.hhdm_first_slot = (_boot_meta.hhdm_vaddr >> shift) & 0x1FF;
+	warm_desc.hhdm_last_slot = (hhdm_end >> shift) & 0x1FF;
+	warm_desc.hhdm_sum = hhdm_sum(pml4, warm_desc.hhdm_first_slot, warm_desc.hhdm_last_slot);
+	warm_desc.hhdm_vaddr = _boot_meta.hhdm_vaddr;
+
+	warm_desc.checksum = -byte_sum(&warm_desc, sizeof(warm_desc));
+
+	_boot_meta.warm_entry = (uintptr_t)&_warm_entry;
+	_boot_meta.warm_desc = (uintptr_t)&warm_desc;
+
+	return 0;
+}
+
+int check_warm_desc() {
+	if (warm_desc.magic != ARC_WARM_MAGIC || byte_sum(&warm_desc, sizeof(warm_desc)) != 0) {
+		ARC_DEBUG(ERR, "Warm reboot descriptor is corrupt\n");
+		return -1;
+	}
+
+	if (warm_desc.pml4 != (uintptr_t)pml4 || (warm_desc.pml4 & 0xFFF) != 0 || warm_desc.levels != (uint32_t)vmm_levels) {
+		ARC_DEBUG(ERR, "Root page table has been changed\n");
+		return -1;
+	}
+
+	// Only the bounds of the freelist are trusted, the nodes lived in
+	// memory the previous kernel owned, rebuild_pmm replaces them
+	if (warm_desc.pmm_base != (uintptr_t)physical_mem.base || warm_desc.pmm_ciel != (uintptr_t)physical_mem.ciel ||
+	    warm_desc.pmm_base > warm_desc.pmm_ciel) {
+		ARC_DEBUG(ERR, "PMM bounds have been changed\n");
+		return -1;
+	}
+
+	if (warm_desc.hhdm_vaddr != _boot_meta.hhdm_vaddr ||
+	    warm_desc.hhdm_sum != hhdm_sum(pml4, warm_desc.hhdm_first_slot, warm_desc.hhdm_last_slot)) {
+		ARC_DEBUG(ERR, "HHDM has been changed\n");
+		return -1;
+	}
+
+	return 0;
+}
+
+void reset_kernel_state() {
+	for (int i = 1; i < 512; i++) {
+		if (!is_hhdm_slot(i)) {
+			pml4[i] = 0;
+		}
+	}
+
+	_boot_meta.sym_table = 0;
+	_boot_meta.sym_table_size = 0;
+	_boot_meta.str_table = 0;
+	_boot_meta.str_table_hhdm = 0;
+	_boot_meta.str_table_size = 0;
+	_boot_meta.sym_index = 0;
+	_boot_meta.sym_index_hhdm = 0;
+	_boot_meta.sym_index_len = 0;
+	_boot_meta.kernel_stack = 0;
+	_boot_meta.kernel_stack_size = 0;
+	_boot_meta.alt_patched = 0;
+	_boot_meta.early_heap = 0;
+	_boot_meta.early_heap_paddr = 0;
+	_boot_meta.early_heap_size = 0;
+	_boot_meta.percpu = 0;
+	_boot_meta.percpu_paddr = 0;
+	_boot_meta.percpu_size = 0;
+	_boot_meta.boot_plan_used = 0;
+	_boot_meta.cpu_desc = 0;
+	_boot_meta.cpu_desc_paddr = 0;
+	_boot_meta.cpu_desc_count = 0;
+	_boot_meta.tls = 0;
+	_boot_meta.tls_paddr = 0;
+	_boot_meta.tls_stride = 0;
+	_boot_meta.tls_offset = 0;
+	_boot_meta.drivers = 0;
+	_boot_meta.drivers_hhdm = 0;
+	_boot_meta.driver_count = 0;
+	_boot_meta.modules = 0;
+	_boot_meta.modules_hhdm = 0;
+	_boot_meta.module_count = 0;
+	_boot_meta.module_slots = 0;
+}
+
+static uint64_t *read_table(uint64_t paddr, void *ctx) {
+	(void)ctx;
+
+	if (paddr >= 0x100000000ULL) {
+		return NULL;
+	}
+
+	return (uint64_t *)((uint32_t)paddr);
+}
+
+static void keep_table(int level, uint64_t paddr, void *ctx) {
+	(void)level;
+	int *overflow = (int *)ctx;
+
+	if (kept_count == ARC_WARM_MAX_TABLES) {
+		*overflow = 1;
+		return;
+	}
+
+	// Insert in order
+	int i = kept_count++;
+
+	for (; i > 0 && kept_tables[i - 1] > paddr; i--) {
+		kept_tables[i] = kept_tables[i - 1];
+	}
+
+	kept_tables[i] = paddr;
+}
+
+static int is_kept(uint64_t frame, struct warm_range *ranges, int count) {
+	for (int i = 0; i < count; i++) {
+		if (frame + 0x1000 > ranges[i].base && frame < ranges[i].end) {
+			return 1;
+		}
+	}
+
+	int low = 0;
+	int high = kept_count - 1;
+
+	while (low <= high) {
+		int mid = (low + high) / 2;
+
+		if (kept_tables[mid] == frame) {
+			return 1;
+		} else if (kept_tables[mid] < frame) {
+			low = mid + 1;
+		} else {
+			high = mid - 1;
+		}
+	}
+
+	return 0;
+}
+
+// Return 0: success
+int rebuild_pmm(struct ARC_WarmArgs *args) {
+	struct ARC_PTWalk walk = { 0 };
+	int overflow = 0;
+
+	kept_count = 0;
+	walk.levels = vmm_levels;
+	walk.read = read_table;
+	walk.table = keep_table;
+	walk.ctx = &overflow;
+
+	// Only the identity map and HHDM are left in the root
+	pt_walk(&walk, (uintptr_t)pml4);
+
+	if (overflow) {
+		ARC_DEBUG(ERR, "More than %d page tables to keep\n", ARC_WARM_MAX_TABLES);
+		return -1;
+	}
+
+	// What is handed to the new kernel as it is, the new kernel's ELF, and
+	// the handoff structures which are not built again
+	struct warm_range ranges[] = {
+		{ args->kernel_elf, args->kernel_elf + args->kernel_elf_size },
+		{ _boot_meta.arc_mmap, _boot_meta.arc_mmap + _boot_meta.arc_mmap_len * sizeof(struct ARC_MMap) },
+		{ _boot_meta.hhdm_ranges, _boot_meta.hhdm_ranges + _boot_meta.hhdm_ranges_len * sizeof(struct ARC_HHDMRange) },
+		{ _boot_meta.hhdm_lazy, _boot_meta.hhdm_lazy + (_boot_meta.hhdm_lazy != 0 ? 0x1000 : 0) },
+		{ _boot_meta.apic_map, _boot_meta.apic_map + _boot_meta.apic_map_len * sizeof(uint32_t) },
+	};
+	int range_count = sizeof(ranges) / sizeof(*ranges);
+
+	struct ARC_MMap *mmap = (struct ARC_MMap *)((uint32_t)_boot_meta.arc_mmap);
+	uint64_t base = warm_desc.pmm_base;
+	uint64_t ceil = warm_desc.pmm_ciel + 0x1000;
+	int pages = 0;
+
+	// Everything else within the bounds of the freelist is free. Frames
+	// are pushed from the top down, so the list ascends like a new one
+	physical_mem.head = NULL;
+
+	for (int i = _boot_meta.arc_mmap_len - 1; i >= 0; i--) {
+		if (mmap[i].type != MULTIBOOT_MEMORY_AVAILABLE) {
+			continue;
+		}
+
+		uint64_t low = ALIGN(max(mmap[i].base, base), 0x1000);
+		uint64_t high = min(mmap[i].base + mmap[i].len, ceil) & ~0xFFFULL;
+
+		for (uint64_t frame = high; frame > low; frame -= 0x1000) {
+			if (is_kept(frame - 0x1000, ranges, range_count)) {
+				continue;
+			}
+
+			Arc_ListFree(&physical_mem, (void *)((uint32_t)(frame - 0x1000)));
+			pages++;
+		}
+	}
+
+	if (physical_mem.head == NULL) {
+		ARC_DEBUG(ERR, "No free memory left after a warm reboot\n");
+		return -1;
+	}
+
+	ARC_DEBUG(INFO, "Rebuilt PMM with %d free page(s), kept %d page table(s)\n", pages, kept_count);
+
+	return 0;
+}
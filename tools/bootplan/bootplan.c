@@ -0,0 +1,367 @@
+/**
+ * @file bootplan.c
+ *
+ * @author awewsomegamer <awewsomegamer@gmail.com>
+ *
+ * @LICENSE
+ * Arctan-MB2BSP - Multiboot2 Bootstrapper for Arctan Kernel
+ * Copyright (C) 2023-2024 awewsomegamer
+ *
+ * This file is part of Arctan-MB2BSP
+ *
+ * Arctan is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; version 2
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * @DESCRIPTION
+ * Host tool which precompiles the page tables and copy lists needed to
+ * load a kernel ELF into a boot plan module (arctan-module.bootplan).
+*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <unistd.h>
+#include <elf.h>
+#include <arctan.h>
+
+#define MAX_TABLES 4096
+#define ADDRESS_MASK 0x000FFFFFFFFFF000ULL
+
+static uint64_t root[512] = { 0 };
+static uint64_t tables[MAX_TABLES][512] = { 0 };
+static int table_count = 0;
+
+static int levels = 4;
+static int large_pages = 1;
+
+static void *read_file(const char *path, size_t *size) {
+	FILE *file = fopen(path, "rb");
+
+	if (file == NULL) {
+		perror(path);
+		return NULL;
+	}
+
+	fseek(file, 0, SEEK_END);
+	*size = ftell(file);
+	fseek(file, 0, SEEK_SET);
+
+	void *data = malloc(*size);
+
+	if (data == NULL || fread(data, 1, *size, file) != *size) {
+		fprintf(stderr, "Failed to read %s\n", path);
+		fclose(file);
+		free(data);
+		return NULL;
+	}
+
+	fclose(file);
+
+	return data;
+}
+
+// Must match elf_header_hash in src/c/elf/elf.c
+static uint32_t header_hash(uint8_t *file) {
+	Elf64_Ehdr *header = (Elf64_Ehdr *)file;
+	uint32_t hash = 0x811C9DC5;
+
+	for (size_t i = 0; i < sizeof(Elf64_Ehdr); i++) {
+		hash = (hash ^ file[i]) * 0x01000193;
+	}
+
+	for (size_t i = 0; i < (size_t)header->e_phnum * header->e_phentsize; i++) {
+		hash = (hash ^ file[header->e_phoff + i]) * 0x01000193;
+	}
+
+	return hash;
+}
+
+// Turn off large pages if the kernel's notes rule them out
+static void read_notes(uint8_t *file, Elf64_Ehdr *header) {
+	Elf64_Phdr *program_headers = (Elf64_Phdr *)(file + header->e_phoff);
+
+	for (int i = 0; i < header->e_phnum; i++) {
+		if (program_headers[i].p_type != PT_NOTE) {
+			continue;
+		}
+
+		uint8_t *note = file + program_headers[i].p_offset;
+		uint8_t *end = note + program_headers[i].p_filesz;
+
+		while (note + sizeof(Elf64_Nhdr) <= end) {
+			Elf64_Nhdr *nhdr = (Elf64_Nhdr *)note;
+			char *name = (char *)(nhdr + 1);
+			uint8_t *desc = (uint8_t *)name + ((nhdr->n_namesz + 3) & ~3);
+
+			if (nhdr->n_namesz == sizeof(ARC_NOTE_OWNER) && memcmp(name, ARC_NOTE_OWNER, sizeof(ARC_NOTE_OWNER)) == 0
+			    && nhdr->n_type == ARC_NOTE_PAGE_SIZES && nhdr->n_descsz >= sizeof(uint64_t)
+			    && (*(uint64_t *)desc & ARC_NOTE_PAGE_2M) == 0) {
+				large_pages = 0;
+			}
+
+			note = desc + ((nhdr->n_descsz + 3) & ~3);
+		}
+	}
+}
+
+static uint64_t *next_table(uint64_t *parent, int index) {
+	if ((parent[index] & 1) == 0) {
+		if (table_count == MAX_TABLES) {
+			fprintf(stderr, "More than %d page tables needed\n", MAX_TABLES);
+			exit(1);
+		}
+
+		parent[index] = ((uint64_t)table_count << 12) | ARC_PLAN_REF_TABLE | 3;
+		table_count++;
+	}
+
+	return tables[(parent[index] & ADDRESS_MASK) >> 12];
+}
+
+// Return the table of the given level which holds the entry for vaddr
+static uint64_t *get_table(uint64_t vaddr, int level) {
+	uint64_t *table = root;
+
+	for (int i = levels; i > level; i--) {
+		table = next_table(table, (vaddr >> (12 + 9 * (i - 1))) & 0x1FF);
+	}
+
+	return table;
+}
+
+static int compare_copies(const void *a, const void *b) {
+	const struct ARC_PlanCopy *x = a;
+	const struct ARC_PlanCopy *y = b;
+
+	return (x->offset > y->offset) - (x->offset < y->offset);
+}
+
+static void usage(const char *name) {
+	fprintf(stderr, "Usage: %s [-l levels] [-s] kernel.elf bootplan\n", name);
+	fprintf(stderr, "\t-l levels\tBuild tables for 4 or 5 level paging (default: 4)\n");
+	fprintf(stderr, "\t-s\t\tOnly use 4 KiB pages\n");
+}
+
+int main(int argc, char **argv) {
+	int opt;
+
+	while ((opt = getopt(argc, argv, "l:s")) != -1) {
+		switch (opt) {
+		case 'l': {
+			levels = atoi(optarg);
+			break;
+		}
+
+		case 's': {
+			large_pages = 0;
+			break;
+		}
+
+		default: {
+			usage(argv[0]);
+			return 1;
+		}
+		}
+	}
+
+	if (argc - optind != 2 || (levels != 4 && levels != 5)) {
+		usage(argv[0]);
+		return 1;
+	}
+
+	size_t size = 0;
+	uint8_t *file = read_file(argv[optind], &size);
+
+	if (file == NULL) {
+		return 1;
+	}
+
+	Elf64_Ehdr *header = (Elf64_Ehdr *)file;
+
+	if (size < sizeof(Elf64_Ehdr) || memcmp(header->e_ident, ELFMAG, SELFMAG) != 0
+	    || header->e_ident[EI_CLASS] != ELFCLASS64 || header->e_machine != EM_X86_64
+	    || header->e_phoff + (uint64_t)header->e_phnum * header->e_phentsize > size) {
+		fprintf(stderr, "%s is not an x86-64 ELF file\n", argv[optind]);
+		return 1;
+	}
+
+	read_notes(file, header);
+
+	// Lay the image out as relocate_segments does
+	Elf64_Phdr *program_headers = (Elf64_Phdr *)(file + header->e_phoff);
+	uint64_t lowest = (uint64_t)-1;
+	uint64_t highest = 0;
+	int segments = 0;
+
+	for (int i = 0; i < header->e_phnum; i++) {
+		Elf64_Phdr *segment = &program_headers[i];
+
+		if (segment->p_type != PT_LOAD || segment->p_memsz == 0) {
+			continue;
+		}
+
+		if (segment->p_offset + segment->p_filesz > size) {
+			fprintf(stderr, "Segment %d is truncated\n", i);
+			return 1;
+		}
+
+		uint64_t end = (segment->p_vaddr + segment->p_memsz + 0xFFF) & ~0xFFFULL;
+
+		lowest = segment->p_vaddr < lowest ? segment->p_vaddr & ~0xFFFULL : lowest;
+		highest = end > highest ? end : highest;
+		segments++;
+	}
+
+	if (segments == 0) {
+		fprintf(stderr, "No PT_LOAD segments\n");
+		return 1;
+	}
+
+	uint32_t phase = (lowest & 0x1FFFFF) / 0x1000;
+	uint32_t frames = (highest - lowest) / 0x1000;
+
+	// Flags of each page, 0 if it is not mapped. Segments sharing a
+	// page share a frame, the last one's flags win
+	uint8_t *page_flags = calloc(frames, 1);
+	struct ARC_PlanCopy *copies = calloc(segments, sizeof(struct ARC_PlanCopy));
+	int copy_count = 0;
+
+	for (int i = 0; i < header->e_phnum; i++) {
+		Elf64_Phdr *segment = &program_headers[i];
+
+		if (segment->p_type != PT_LOAD || segment->p_memsz == 0) {
+			continue;
+		}
+
+		uint64_t first = ((segment->p_vaddr & ~0xFFFULL) - lowest) / 0x1000;
+		uint64_t last = ((segment->p_vaddr + segment->p_memsz + 0xFFF) & ~0xFFFULL) - lowest;
+
+		for (uint64_t j = first; j < last / 0x1000; j++) {
+			page_flags[j] = 1 | ((segment->p_flags & PF_W) ? (1 << 1) : 0);
+		}
+
+		if (segment->p_filesz > 0) {
+			copies[copy_count].offset = segment->p_vaddr - lowest;
+			copies[copy_count].file_offset = segment->p_offset;
+			copies[copy_count].size = segment->p_filesz;
+			copy_count++;
+		}
+	}
+
+	// Map the image, using 2 MiB pages for whole, uniform 2 MiB runs
+	uint64_t vaddr = lowest;
+	int large_count = 0;
+
+	while (vaddr < highest) {
+		uint32_t frame = (vaddr - lowest) / 0x1000;
+		uint8_t flags = page_flags[frame];
+
+		int large = large_pages && (vaddr & 0x1FFFFF) == 0 && frame + 512 <= frames && flags != 0;
+
+		for (int j = 1; large && j < 512; j++) {
+			large = page_flags[frame + j] == flags;
+		}
+
+		if (large) {
+			uint64_t *pml2 = get_table(vaddr, 2);
+
+			pml2[(vaddr >> 21) & 0x1FF] = ((uint64_t)frame << 12) | ARC_PLAN_REF_FRAME | flags | (1 << 7);
+			vaddr += 0x200000;
+			large_count++;
+
+			continue;
+		}
+
+		if (flags != 0) {
+			uint64_t *pml1 = get_table(vaddr, 1);
+
+			pml1[(vaddr >> 12) & 0x1FF] = ((uint64_t)frame << 12) | ARC_PLAN_REF_FRAME | flags;
+		}
+
+		vaddr += 0x1000;
+	}
+
+	// Zero everything in the image the copies do not cover
+	qsort(copies, copy_count, sizeof(struct ARC_PlanCopy), compare_copies);
+
+	struct ARC_PlanZero *zeros = calloc(copy_count + 1, sizeof(struct ARC_PlanZero));
+	int zero_count = 0;
+	uint64_t cursor = 0;
+
+	for (int i = 0; i <= copy_count; i++) {
+		uint64_t start = i < copy_count ? copies[i].offset : (uint64_t)frames * 0x1000;
+
+		if (start > cursor) {
+			zeros[zero_count].offset = cursor;
+			zeros[zero_count].size = start - cursor;
+			zero_count++;
+		}
+
+		if (i < copy_count && copies[i].offset + copies[i].size > cursor) {
+			cursor = copies[i].offset + copies[i].size;
+		}
+	}
+
+	struct ARC_PlanRoot roots[512] = { 0 };
+	int root_count = 0;
+
+	for (int i = 0; i < 512; i++) {
+		if ((root[i] & 1) == 1) {
+			roots[root_count].slot = i;
+			roots[root_count].entry = root[i];
+			root_count++;
+		}
+	}
+
+	struct ARC_PlanHeader plan = { 0 };
+
+	plan.magic = ARC_PLAN_MAGIC;
+	plan.version = ARC_PLAN_VERSION;
+	plan.kernel_hash = header_hash(file);
+	plan.levels = levels;
+	plan.large_pages = large_count > 0;
+	plan.phase = phase;
+	plan.frame_count = frames;
+	plan.table_count = table_count;
+	plan.root_count = root_count;
+	plan.copy_count = copy_count;
+	plan.zero_count = zero_count;
+	plan.entry = header->e_entry;
+	plan.roots_offset = sizeof(struct ARC_PlanHeader);
+	plan.copies_offset = plan.roots_offset + root_count * sizeof(struct ARC_PlanRoot);
+	plan.zeros_offset = plan.copies_offset + copy_count * sizeof(struct ARC_PlanCopy);
+	plan.tables_offset = (plan.zeros_offset + zero_count * sizeof(struct ARC_PlanZero) + 0xFFF) & ~0xFFFULL;
+
+	FILE *out = fopen(argv[optind + 1], "wb");
+
+	if (out == NULL) {
+		perror(argv[optind + 1]);
+		return 1;
+	}
+
+	fwrite(&plan, sizeof(plan), 1, out);
+	fwrite(roots, sizeof(struct ARC_PlanRoot), root_count, out);
+	fwrite(copies, sizeof(struct ARC_PlanCopy), copy_count, out);
+	fwrite(zeros, sizeof(struct ARC_PlanZero), zero_count, out);
+	fseek(out, plan.tables_offset, SEEK_SET);
+	fwrite(tables, 0x1000, table_count, out);
+
+	if (fclose(out) != 0) {
+		perror(argv[optind + 1]);
+		return 1;
+	}
+
+	printf("%s: %d tables, %d pages (%d large), %d copies, %d zeroed ranges\n", argv[optind + 1], table_count, frames, large_count, copy_count, zero_count);
+
+	return 0;
+}
@@ -0,0 +1,167 @@
+/**
+ * @file ptinspect.c
+ *
+ * @author awewsomegamer <awewsomegamer@gmail.com>
+ *
+ * @LICENSE
+ * Arctan-MB2BSP - Multiboot2 Bootstrapper for Arctan Kernel
+ * Copyright (C) 2023-2024 awewsomegamer
+ *
+ * This file is part of Arctan-MB2BSP
+ *
+ * Arctan is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; version 2
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * @DESCRIPTION
+ * Host tool which checks and describes the page tables in a dump of
+ * physical memory, such as one taken with QEMU's pmemsave from 0.
+*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <inttypes.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <mm/ptwalk.h>
+
+struct dump {
+	uint8_t *data;
+	uint64_t size;
+	/// One bit per frame of the dump, set if it was reached as a table.
+	uint8_t *tables;
+	int shared;
+	int quiet;
+};
+
+static uint64_t *read_table(uint64_t paddr, void *ctx) {
+	struct dump *dump = (struct dump *)ctx;
+
+	if (paddr + 0x1000 > dump->size) {
+		return NULL;
+	}
+
+	return (uint64_t *)(dump->data + paddr);
+}
+
+static void check_table(int level, uint64_t paddr, void *ctx) {
+	struct dump *dump = (struct dump *)ctx;
+	uint64_t frame = paddr >> 12;
+
+	if (paddr + 0x1000 > dump->size) {
+		printf("Level %d table 0x%016" PRIx64 " is outside of the dump\n", level, paddr);
+		return;
+	}
+
+	if (dump->tables[frame / 8] & (1 << (frame % 8))) {
+		printf("Level %d table 0x%016" PRIx64 " is reached more than once\n", level, paddr);
+		dump->shared++;
+	}
+
+	dump->tables[frame / 8] |= 1 << (frame % 8);
+}
+
+static void print_range(uint64_t vaddr, uint64_t paddr, uint64_t size, uint64_t flags, void *ctx) {
+	struct dump *dump = (struct dump *)ctx;
+
+	if (dump->quiet) {
+		return;
+	}
+
+	printf("0x%016" PRIx64 " -> 0x%016" PRIx64 " (0x%" PRIx64 " B) %c%c%c%s%s%s\n", vaddr, paddr, size,
+	       (flags & ARC_PT_WRITE) ? 'W' : '-', (flags & ARC_PT_USER) ? 'U' : '-', (flags & ARC_PT_NX) ? '-' : 'X',
+	       (flags & ARC_PT_PCD) ? " UC" : "", (flags & ARC_PT_PAT) ? " PAT" : "", (flags & ARC_PT_GLOBAL) ? " G" : "");
+}
+
+static void usage(const char *name) {
+	fprintf(stderr, "Usage: %s [-l levels] [-q] memory.bin cr3\n", name);
+	fprintf(stderr, "\t-l levels\tWalk 4 or 5 level paging (default: 4)\n");
+	fprintf(stderr, "\t-q\t\tOnly print statistics and problems\n");
+}
+
+int main(int argc, char **argv) {
+	struct dump dump = { 0 };
+	int levels = 4;
+	int opt;
+
+	while ((opt = getopt(argc, argv, "l:q")) != -1) {
+		switch (opt) {
+		case 'l': {
+			levels = atoi(optarg);
+			break;
+		}
+
+		case 'q': {
+			dump.quiet = 1;
+			break;
+		}
+
+		default: {
+			usage(argv[0]);
+			return 1;
+		}
+		}
+	}
+
+	if (argc - optind != 2 || (levels != 4 && levels != 5)) {
+		usage(argv[0]);
+		return 1;
+	}
+
+	int fd = open(argv[optind], O_RDONLY);
+	struct stat info;
+
+	if (fd < 0 || fstat(fd, &info) != 0) {
+		perror(argv[optind]);
+		return 1;
+	}
+
+	dump.size = info.st_size;
+	dump.data = mmap(NULL, dump.size, PROT_READ, MAP_PRIVATE, fd, 0);
+	dump.tables = calloc((dump.size >> 12) / 8 + 1, 1);
+
+	if (dump.data == MAP_FAILED || dump.tables == NULL) {
+		perror(argv[optind]);
+		return 1;
+	}
+
+	uint64_t root = strtoull(argv[optind + 1], NULL, 0) & ARC_PT_ADDRESS;
+
+	struct ARC_PTWalk walk = { 0 };
+	walk.levels = levels;
+	walk.read = read_table;
+	walk.table = check_table;
+	walk.range = print_range;
+	walk.ctx = &dump;
+
+	pt_walk(&walk, root);
+
+	uint32_t total = 0;
+
+	for (int i = levels; i > 0; i--) {
+		printf("Level %d tables: %u\n", i, walk.tables[i]);
+		total += walk.tables[i];
+	}
+
+	printf("Table memory: %u KiB\n", total * 4);
+	printf("Pages: %" PRIu64 " 4 KiB, %" PRIu64 " 2 MiB, %" PRIu64 " 1 GiB\n", walk.pages[0], walk.pages[1], walk.pages[2]);
+	printf("Mapped: %" PRIu64 " KiB\n", walk.pages[0] * 4 + walk.pages[1] * 2048 + walk.pages[2] * 1048576);
+	printf("Recursive entries: %u\n", walk.recursive);
+
+	munmap(dump.data, dump.size);
+	close(fd);
+
+	return walk.unreadable != 0 || dump.shared != 0;
+}